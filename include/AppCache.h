@@ -0,0 +1,90 @@
+#ifndef APP_CACHE_H
+#define APP_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "AppDiscovery.h"
+#include "MappedFile.h"
+
+namespace BreadBin {
+struct FileStamp {
+  uint64_t device = 0;
+  uint64_t inode = 0;
+  int64_t modified_ns = 0;
+  uint64_t size = 0;
+
+  bool operator==(const FileStamp& other) const {
+    return device == other.device && inode == other.inode &&
+           modified_ns == other.modified_ns && size == other.size;
+  }
+};
+
+struct SourceFingerprint {
+  std::string directory;
+  FileStamp stamp;
+};
+
+class AppCache {
+ public:
+  static constexpr uint32_t k_version = 1;
+
+  class Entry {
+   public:
+    [[nodiscard]] std::string_view GetName() const;
+    [[nodiscard]] std::string_view GetExecutable() const;
+    [[nodiscard]] std::string_view GetDescription() const;
+    [[nodiscard]] std::string_view GetIconPath() const;
+    [[nodiscard]] std::string_view GetCategory() const;
+    [[nodiscard]] size_t GetFlagCount() const;
+    [[nodiscard]] std::string_view GetFlag(size_t index) const;
+    [[nodiscard]] size_t GetMetadataCount() const;
+    [[nodiscard]] std::pair<std::string_view, std::string_view> GetMetadata(
+        size_t index) const;
+    [[nodiscard]] AppInfo ToAppInfo() const;
+
+   private:
+    friend class AppCache;
+    Entry(const AppCache* cache, const char* record);
+
+    const AppCache* cache_;
+    const char* record_;
+  };
+
+  AppCache();
+  ~AppCache();
+  AppCache(const AppCache&) = delete;
+  AppCache& operator=(const AppCache&) = delete;
+
+  bool Open(const std::string& filepath);
+  void Close();
+  [[nodiscard]] bool IsOpen() const;
+  [[nodiscard]] size_t GetSize() const;
+  [[nodiscard]] Entry GetEntry(size_t index) const;
+  [[nodiscard]] bool IsFresh(const std::vector<std::string>& directories) const;
+
+  static bool Write(const std::string& filepath,
+                    const std::vector<AppInfo>& applications,
+                    const std::vector<SourceFingerprint>& sources);
+  static bool ReadStamp(const std::string& path, FileStamp* stamp);
+
+ private:
+  [[nodiscard]] std::string_view GetString(const char* reference) const;
+
+  MappedFile file_;
+  const char* sources_;
+  const char* entries_;
+  const char* references_;
+  const char* strings_;
+  size_t source_count_;
+  size_t entry_count_;
+  size_t reference_count_;
+  size_t string_size_;
+};
+}  // namespace BreadBin
+
+#endif  // APP_CACHE_H
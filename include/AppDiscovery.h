@@ -1,13 +1,20 @@
 #ifndef APPDISCOVERY_H
 #define APPDISCOVERY_H
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 namespace BreadBin {
+class AppCache;
+class AppSearchIndex;
+
 struct AppInfo {
   std::string name;
   std::string executable;
@@ -22,30 +29,52 @@ struct AppInfo {
       : name(std::move(name)), executable(std::move(executable)) {}
 };
 
+struct ScanProgress {
+  size_t completed = 0;
+  size_t total = 0;
+  size_t found = 0;
+};
+
+struct ScanOptions {
+  size_t max_workers = 0;
+  std::function<void(const ScanProgress&)> on_progress;
+  const std::atomic<bool>* cancelled = nullptr;
+};
+
 class AppDiscovery {
  public:
   AppDiscovery();
   ~AppDiscovery();
 
   size_t ScanSystem();
+  size_t ScanSystem(const ScanOptions& options);
   [[nodiscard]] const std::vector<AppInfo>& GetApplications() const;
-  [[nodiscard]] std::vector<AppInfo> SearchApplications(
-      const std::string& query) const;
+  [[nodiscard]] size_t GetApplicationCount() const;
+  [[nodiscard]] std::string_view GetApplicationName(size_t index) const;
+  [[nodiscard]] std::string_view GetApplicationCategory(size_t index) const;
+  [[nodiscard]] AppInfo GetApplication(size_t index) const;
+  [[nodiscard]] std::vector<size_t> SearchApplications(
+      const std::string& query, size_t limit = 0) const;
   [[nodiscard]] std::vector<AppInfo> GetApplicationsByCategory(
       const std::string& category) const;
   [[nodiscard]] std::vector<std::string> GetCategories() const;
+  [[nodiscard]] static std::vector<std::string> GetWatchDirectories();
+  void SetApplications(std::vector<AppInfo> applications);
   void clear();
   [[nodiscard]] bool SaveCache(const std::string& filepath) const;
-  bool LoadCache(const std::string& filepath);
+  bool LoadCache(const std::string& filepath, bool* is_fresh = nullptr);
 
  private:
-  void ScanLinuxApplications();
-  void ScanWindowsApplications();
-  void ScanMacOSApplications();
-  void ScanPathEnvironment();
+  struct ScanState;
+
   static AppInfo ParseDesktopFile(const std::string& filepath);
 
-  std::vector<AppInfo> applications_;
+  // After LoadCache() the entries are read from the mapped cache_ until
+  // GetApplications() needs them as AppInfo.
+  mutable std::vector<AppInfo> applications_;
+  mutable std::unique_ptr<AppCache> cache_;
+  std::unique_ptr<ScanState> scan_state_;
+  mutable std::unique_ptr<AppSearchIndex> search_index_;
 };
 }  // namespace BreadBin
 
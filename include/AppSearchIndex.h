@@ -0,0 +1,51 @@
+#ifndef APP_SEARCH_INDEX_H
+#define APP_SEARCH_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "AppDiscovery.h"
+
+namespace BreadBin {
+class AppCache;
+
+class AppSearchIndex {
+ public:
+  void Build(const std::vector<AppInfo>& applications);
+  void Build(const AppCache& cache);
+  void Clear();
+  [[nodiscard]] size_t GetSize() const;
+  [[nodiscard]] std::vector<size_t> Search(std::string_view query,
+                                           size_t limit = 0) const;
+
+ private:
+  struct Document {
+    std::string name;
+    std::string executable;
+    std::string category;
+    std::string description;
+    std::string_view command;
+    uint64_t name_mask = 0;
+    uint64_t command_mask = 0;
+  };
+
+  void AddDocument(std::string_view name, std::string_view executable,
+                   std::string_view category, std::string_view description);
+  void SortByName();
+  [[nodiscard]] std::vector<uint32_t> FindTrigramCandidates(
+      std::string_view query) const;
+  [[nodiscard]] static int Score(const Document& document,
+                                 std::string_view query, uint64_t query_mask,
+                                 bool use_details);
+
+  std::vector<Document> documents_;
+  std::vector<uint32_t> name_order_;
+  std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams_;
+};
+}  // namespace BreadBin
+
+#endif  // APP_SEARCH_INDEX_H
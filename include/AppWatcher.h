@@ -0,0 +1,45 @@
+#ifndef APP_WATCHER_H
+#define APP_WATCHER_H
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace BreadBin {
+class AppWatcher {
+ public:
+  using Callback = std::function<void()>;
+
+  static constexpr std::chrono::milliseconds k_default_settle_delay{250};
+
+  explicit AppWatcher(Callback callback,
+                      std::chrono::milliseconds settle_delay =
+                          k_default_settle_delay);
+  ~AppWatcher();
+  AppWatcher(const AppWatcher&) = delete;
+  AppWatcher& operator=(const AppWatcher&) = delete;
+
+  static bool IsSupported();
+
+  bool Start(const std::vector<std::string>& directories);
+  void Stop();
+  [[nodiscard]] bool IsActive() const;
+
+ private:
+  void Loop();
+  bool Rearm();
+
+  Callback callback_;
+  std::chrono::milliseconds settle_delay_;
+  std::thread thread_;
+  std::vector<std::string> directories_;
+  std::unordered_set<int> directory_watches_;
+  int inotify_descriptor_;
+  int wake_descriptor_;
+};
+}  // namespace BreadBin
+
+#endif  // APP_WATCHER_H
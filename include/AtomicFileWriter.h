@@ -0,0 +1,36 @@
+#ifndef ATOMIC_FILE_WRITER_H
+#define ATOMIC_FILE_WRITER_H
+
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace BreadBin {
+enum class SyncPolicy { NONE, FILE, FILE_AND_DIRECTORY };
+
+class AtomicFileWriter {
+ public:
+  explicit AtomicFileWriter(std::string filepath);
+  AtomicFileWriter(std::string filepath, SyncPolicy policy);
+  AtomicFileWriter(const AtomicFileWriter&) = delete;
+  AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+
+  std::ostream& Stream();
+  bool Commit();
+  [[nodiscard]] const std::string& GetError() const;
+
+  static bool WriteFile(const std::string& filepath, std::string_view contents,
+                        SyncPolicy policy, std::string* error = nullptr);
+  static void SetDefaultSyncPolicy(SyncPolicy policy);
+  static SyncPolicy GetDefaultSyncPolicy();
+
+ private:
+  std::string filepath_;
+  SyncPolicy policy_;
+  std::ostringstream buffer_;
+  std::string error_;
+};
+}  // namespace BreadBin
+
+#endif  // ATOMIC_FILE_WRITER_H
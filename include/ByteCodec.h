@@ -0,0 +1,35 @@
+#ifndef BYTE_CODEC_H
+#define BYTE_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace BreadBin {
+// Little-endian integers and strings with a 32-bit length prefix, as used by
+// the binary loaf, application cache and control socket formats.
+void WriteInteger(std::string& buffer, uint64_t value, size_t bytes);
+void WriteString(std::string& buffer, std::string_view value);
+[[nodiscard]] uint64_t ReadInteger(const char* data, size_t bytes);
+
+// Reading past the end of the data marks the reader invalid; every later
+// read then returns zero or an empty string.
+class ByteReader {
+ public:
+  explicit ByteReader(std::string_view data);
+
+  uint64_t ReadInteger(size_t bytes);
+  std::string ReadString();
+  [[nodiscard]] bool IsValid() const;
+  [[nodiscard]] bool IsComplete() const;
+
+ private:
+  bool Require(size_t bytes);
+
+  std::string_view data_;
+  bool valid_;
+};
+}  // namespace BreadBin
+
+#endif  // BYTE_CODEC_H
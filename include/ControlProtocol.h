@@ -0,0 +1,65 @@
+#ifndef CONTROL_PROTOCOL_H
+#define CONTROL_PROTOCOL_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BreadBin {
+enum class ControlCommand : uint8_t {
+  START = 1,
+  STOP = 2,
+  STATUS = 3,
+  SHUTDOWN = 4
+};
+
+struct ControlRequest {
+  ControlCommand command = ControlCommand::STATUS;
+  std::string target;
+};
+
+struct ItemStatus {
+  std::string id;
+  uint8_t state = 0;
+  int32_t exit_code = 0;
+  uint32_t restart_count = 0;
+  int64_t process_id = -1;
+};
+
+struct LoafStatus {
+  std::string id;
+  std::string name;
+  std::string state;
+  std::string error;
+  std::vector<ItemStatus> items;
+};
+
+struct ControlResponse {
+  bool ok = false;
+  std::string message;
+  std::vector<LoafStatus> loafs;
+};
+
+class ControlProtocol {
+ public:
+  static constexpr uint32_t k_max_frame_size = 1 << 20;
+
+  static std::string EncodeRequest(const ControlRequest& request);
+  static bool DecodeRequest(std::string_view payload, ControlRequest* request);
+  static std::string EncodeResponse(const ControlResponse& response);
+  static bool DecodeResponse(std::string_view payload,
+                             ControlResponse* response);
+
+  static std::string Frame(std::string_view payload);
+  static bool TakeFrame(std::string* buffer, std::string* payload,
+                        bool* malformed);
+
+  static std::string DefaultSocketPath();
+  static bool Call(const std::string& socket_path,
+                   const ControlRequest& request, ControlResponse* response,
+                   std::string* error);
+};
+}  // namespace BreadBin
+
+#endif  // CONTROL_PROTOCOL_H
@@ -0,0 +1,59 @@
+#ifndef DEPENDENCY_GRAPH_H
+#define DEPENDENCY_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "LoafItem.h"
+
+namespace BreadBin {
+class DependencyGraph {
+ public:
+  DependencyGraph();
+  explicit DependencyGraph(const std::vector<std::shared_ptr<LoafItem>>& items);
+
+  [[nodiscard]] size_t GetNodeCount() const;
+  [[nodiscard]] const std::shared_ptr<LoafItem>& GetItem(size_t index) const;
+  [[nodiscard]] bool FindIndex(const std::string& id, size_t* index) const;
+  [[nodiscard]] const std::vector<size_t>& GetDependencies(size_t index) const;
+  [[nodiscard]] const std::vector<size_t>& GetDependents(size_t index) const;
+  [[nodiscard]] std::vector<size_t> GetTransitiveDependents(size_t index) const;
+  [[nodiscard]] bool HasCycle() const;
+  [[nodiscard]] const std::vector<size_t>& GetTopologicalOrder() const;
+  [[nodiscard]] const std::vector<std::vector<size_t>>& GetLevels() const;
+  [[nodiscard]] const std::vector<size_t>& GetCriticalPath() const;
+  [[nodiscard]] std::vector<size_t> GetCriticalPath(
+      const std::vector<double>& weights) const;
+  [[nodiscard]] const std::vector<std::string>& GetCycle() const;
+  [[nodiscard]] const std::vector<std::string>& GetWarnings() const;
+  [[nodiscard]] std::string DescribeCycle() const;
+  [[nodiscard]] bool IsCurrent(
+      const std::vector<std::shared_ptr<LoafItem>>& items) const;
+
+ private:
+  struct Node {
+    std::shared_ptr<LoafItem> item;
+    uint64_t revision = 0;
+    std::vector<size_t> dependencies;
+    std::vector<size_t> dependents;
+  };
+
+  void Sort();
+  void FindCycle();
+  void ComputeLevels();
+
+  std::vector<Node> nodes_;
+  std::unordered_map<std::string, size_t> index_by_id_;
+  std::vector<size_t> order_;
+  std::vector<std::vector<size_t>> levels_;
+  std::vector<size_t> critical_path_;
+  std::vector<std::string> cycle_;
+  std::vector<std::string> warnings_;
+};
+}  // namespace BreadBin
+
+#endif  // DEPENDENCY_GRAPH_H
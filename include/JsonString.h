@@ -0,0 +1,14 @@
+#ifndef JSON_STRING_H
+#define JSON_STRING_H
+
+#include <string>
+#include <string_view>
+
+namespace BreadBin {
+// Appends value as a quoted JSON string, escaping quotes, backslashes and
+// control characters. Other bytes are copied as they are, so UTF-8 input
+// stays UTF-8.
+void AppendJsonString(std::string& out, std::string_view value);
+}  // namespace BreadBin
+
+#endif  // JSON_STRING_H
@@ -0,0 +1,82 @@
+#ifndef LAUNCH_SCHEDULER_H
+#define LAUNCH_SCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DependencyGraph.h"
+#include "LoafItem.h"
+
+namespace BreadBin {
+class ReadinessProbe;
+
+enum class LaunchPolicy { FAIL_FAST, CONTINUE_ON_ERROR };
+
+struct ItemLaunchResult {
+  std::string item_id;
+  bool launched = false;
+  bool skipped = false;
+  int exit_code = 0;
+  std::chrono::microseconds latency{0};
+  std::string error;
+};
+
+struct LaunchReport {
+  bool success = false;
+  std::vector<ItemLaunchResult> items;
+  std::string error;
+};
+
+class LaunchScheduler {
+ public:
+  using CompletionCallback = std::function<void(
+      const std::shared_ptr<LoafItem>&, const ItemLaunchResult&)>;
+
+  explicit LaunchScheduler(size_t max_workers = 0,
+                           LaunchPolicy policy = LaunchPolicy::FAIL_FAST);
+  ~LaunchScheduler();
+
+  void SetCompletionCallback(CompletionCallback callback);
+  bool Build(std::shared_ptr<const DependencyGraph> graph);
+  bool Run();
+  void Cancel();
+  [[nodiscard]] size_t GetWorkerCount() const;
+  [[nodiscard]] const LaunchReport& GetReport() const;
+  [[nodiscard]] std::string GetLastError() const;
+
+ private:
+  void WorkerLoop();
+  void StartWorker();
+  bool WaitUntilReady(LoafItem& item, ReadinessProbe& probe);
+  void SkipDependents(size_t index);
+
+  size_t max_workers_;
+  LaunchPolicy policy_;
+  CompletionCallback completion_callback_;
+  std::shared_ptr<const DependencyGraph> graph_;
+  std::vector<size_t> pending_;
+  std::vector<bool> settled_;
+  LaunchReport report_;
+  std::string last_error_;
+  std::deque<size_t> ready_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<std::thread> workers_;
+  size_t running_workers_;
+  size_t probing_workers_;
+  size_t finished_;
+  bool failed_;
+  bool cancelled_;
+  int cancel_descriptor_;
+};
+}  // namespace BreadBin
+
+#endif  // LAUNCH_SCHEDULER_H
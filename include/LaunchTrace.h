@@ -0,0 +1,52 @@
+#ifndef LAUNCH_TRACE_H
+#define LAUNCH_TRACE_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace BreadBin {
+enum class LaunchPhase { QUEUED, SPAWN_START, SPAWN_DONE, FIRST_OUTPUT, READY };
+
+class LaunchTimeline {
+ public:
+  using Clock = std::chrono::steady_clock;
+  static constexpr size_t k_phase_count = 5;
+
+  void Record(LaunchPhase phase, Clock::time_point when = Clock::now());
+  void Reset();
+  [[nodiscard]] bool Has(LaunchPhase phase) const;
+  [[nodiscard]] Clock::time_point Get(LaunchPhase phase) const;
+
+ private:
+  std::array<Clock::time_point, k_phase_count> phases_{};
+};
+
+struct TraceEntry {
+  std::string item_id;
+  std::string name;
+  LaunchTimeline timeline;
+};
+
+class LaunchTrace {
+ public:
+  LaunchTrace();
+  LaunchTrace(LaunchTimeline::Clock::time_point origin,
+              std::vector<TraceEntry> entries);
+
+  [[nodiscard]] LaunchTimeline::Clock::time_point GetOrigin() const;
+  [[nodiscard]] const std::vector<TraceEntry>& GetEntries() const;
+  [[nodiscard]] double GetOffsetMs(const LaunchTimeline& timeline,
+                                   LaunchPhase phase) const;
+  [[nodiscard]] std::string ToChromeTraceJson() const;
+  bool ExportChromeTrace(const std::string& filepath) const;
+
+ private:
+  LaunchTimeline::Clock::time_point origin_;
+  std::vector<TraceEntry> entries_;
+};
+}  // namespace BreadBin
+
+#endif  // LAUNCH_TRACE_H
@@ -1,14 +1,31 @@
 #ifndef LOAF_H
 #define LOAF_H
 
+#include <atomic>
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include "DependencyGraph.h"
+#include "LaunchScheduler.h"
+#include "LoafBinaryFormat.h"
 #include "LoafItem.h"
+#include "ProcessMonitor.h"
+#include "RestartPolicy.h"
 
 namespace BreadBin {
+struct RunOptions {
+  LaunchPolicy policy = LaunchPolicy::FAIL_FAST;
+  std::function<void(const ItemLaunchResult&)> on_item_result;
+  std::function<void(const LaunchReport&)> on_finished;
+};
+
 class Loaf {
  public:
   Loaf();
@@ -17,12 +34,17 @@ class Loaf {
 
   bool Load(const std::string& filepath);
   [[nodiscard]] bool Save(const std::string& filepath) const;
+  [[nodiscard]] bool SaveBinary(const std::string& filepath) const;
+  static bool ReadSummary(const std::string& filepath, LoafSummary* summary);
   void Clear();
-  void AddItem(std::shared_ptr<LoafItem> item);
-  void RemoveItem(const std::string& itemId);
+  bool AddItem(std::shared_ptr<LoafItem> item);
+  bool RemoveItem(const std::string& itemId);
+  [[nodiscard]] bool HasItem(const std::string& itemId) const;
   [[nodiscard]] std::shared_ptr<LoafItem> GetItem(
       const std::string& itemId) const;
   [[nodiscard]] const std::vector<std::shared_ptr<LoafItem>>& GetItems() const;
+  [[nodiscard]] std::shared_ptr<const DependencyGraph> GetDependencyGraph()
+      const;
   void SetName(const std::string& name);
   [[nodiscard]] std::string GetName() const;
   void SetDescription(const std::string& description);
@@ -31,17 +53,56 @@ class Loaf {
   [[nodiscard]] std::string GetLayout() const;
   void SetRuntimeRule(const std::string& key, const std::string& value);
   [[nodiscard]] std::string GetRuntimeRule(const std::string& key) const;
+  [[nodiscard]] const std::map<std::string, std::string>& GetRuntimeRules()
+      const;
   bool Run();
+  std::future<LaunchReport> RunAsync();
+  std::future<LaunchReport> RunAsync(RunOptions options);
   bool Stop();
+  // Joins the launch thread, including its on_finished callback. Must not be
+  // called from that callback.
+  void WaitForLaunch();
   [[nodiscard]] bool IsRunning() const;
+  [[nodiscard]] bool IsLaunching() const;
+  [[nodiscard]] LaunchPolicy GetLaunchPolicy() const;
+  [[nodiscard]] LaunchTrace GetLaunchTrace() const;
+  [[nodiscard]] std::vector<std::string> GetLaunchCriticalPath() const;
+  [[nodiscard]] std::string GetLastError() const;
+  [[nodiscard]] int GetRestartCount(const std::string& itemId) const;
+  void SetItemEventCallback(ProcessMonitor::Callback callback);
 
  private:
+  bool LoadBinary(const std::string& filepath);
+  void NotifyItemEvent(const ItemEvent& event);
+  void OnProcessEvent(const ItemEvent& event);
+  void RestartItem(const std::string& itemId);
+  void StopSupervising();
+  void OnItemLaunched(const std::shared_ptr<LoafItem>& item,
+                      const ItemLaunchResult& result);
+  LaunchReport Launch(LaunchScheduler& scheduler, LaunchPolicy policy);
+  void StopProcesses();
+
   std::string name_;
   std::string description_;
   std::string layout_;
   std::vector<std::shared_ptr<LoafItem>> items_;
+  std::unordered_map<std::string, std::shared_ptr<LoafItem>> item_index_;
   std::map<std::string, std::string> runtime_rules_;
-  bool running_;
+  std::string last_error_;
+  std::atomic<bool> running_;
+  std::atomic<bool> launching_;
+  mutable std::mutex launch_mutex_;
+  std::thread launch_thread_;
+  std::shared_ptr<LaunchScheduler> active_scheduler_;
+  LaunchTimeline::Clock::time_point launch_origin_;
+  mutable std::mutex graph_mutex_;
+  mutable std::shared_ptr<const DependencyGraph> graph_;
+  mutable std::mutex restart_mutex_;
+  std::unordered_map<std::string, RestartTracker> restart_trackers_;
+  bool supervising_;
+  std::mutex event_mutex_;
+  ProcessMonitor::Callback event_callback_;
+  std::unique_ptr<ProcessMonitor> monitor_;
 };
 }  // namespace BreadBin
 
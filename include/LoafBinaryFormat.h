@@ -0,0 +1,57 @@
+#ifndef LOAF_BINARY_FORMAT_H
+#define LOAF_BINARY_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "LoafItem.h"
+
+namespace BreadBin {
+class Loaf;
+
+struct LoafSummary {
+  std::string name;
+  std::string description;
+  std::string layout;
+  size_t item_count = 0;
+};
+
+class LoafBinaryReader {
+ public:
+  static constexpr uint32_t k_version = 1;
+
+  LoafBinaryReader();
+  ~LoafBinaryReader();
+
+  bool Open(const std::string& filepath);
+  [[nodiscard]] const LoafSummary& GetSummary() const;
+  [[nodiscard]] const std::map<std::string, std::string>& GetRuntimeRules()
+      const;
+  [[nodiscard]] std::shared_ptr<LoafItem> ReadItem(size_t index);
+  static bool IsBinaryLoaf(const std::string& filepath);
+  static bool ReadSummary(const std::string& filepath, LoafSummary* summary);
+
+ private:
+  struct Entry {
+    uint64_t offset;
+    uint32_t size;
+  };
+
+  std::ifstream file_;
+  LoafSummary summary_;
+  std::map<std::string, std::string> runtime_rules_;
+  std::vector<Entry> entries_;
+};
+
+class LoafBinaryWriter {
+ public:
+  static bool Write(const Loaf& loaf, const std::string& filepath);
+};
+}  // namespace BreadBin
+
+#endif  // LOAF_BINARY_FORMAT_H
\ No newline at end of file
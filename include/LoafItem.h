@@ -1,8 +1,16 @@
 #ifndef LOAF_ITEM_H
 #define LOAF_ITEM_H
 
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+#include "LaunchTrace.h"
+#include "OutputBuffer.h"
+#include "ProcessLauncher.h"
 
 namespace BreadBin {
 class LoafItem {
@@ -12,6 +20,8 @@ class LoafItem {
   LoafItem(std::string id, Type type);
   virtual ~LoafItem();
 
+  static std::shared_ptr<LoafItem> Create(Type type, const std::string& id);
+
   [[nodiscard]] std::string GetId() const;
   [[nodiscard]] Type GetType() const;
   void SetName(const std::string& name);
@@ -20,50 +30,89 @@ class LoafItem {
   [[nodiscard]] std::string GetPath() const;
   void SetMetadata(const std::string& key, const std::string& value);
   [[nodiscard]] std::string GetMetadata(const std::string& key) const;
-  virtual bool Execute() = 0;
+  [[nodiscard]] const std::map<std::string, std::string>& GetAllMetadata()
+      const;
+  [[nodiscard]] const std::vector<std::string>& GetArguments() const;
+  [[nodiscard]] const std::vector<std::string>& GetDependencies() const;
+  [[nodiscard]] uint64_t GetDependencyRevision() const;
+  bool Execute();
+  // With wait_for_exit false, returns once the process is spawned instead of
+  // waiting for items such as scripts to exit.
+  virtual bool Execute(bool wait_for_exit) = 0;
   virtual bool Validate() const = 0;
   [[nodiscard]] virtual std::string ToString() const;
+  [[nodiscard]] bool IsProcessRunning();
+  [[nodiscard]] ProcessId GetProcessId() const;
+  [[nodiscard]] int GetPollDescriptor() const;
+  [[nodiscard]] int DuplicatePollDescriptor() const;
+  [[nodiscard]] int GetLastExitCode() const;
+  [[nodiscard]] std::string GetLastError() const;
+  void RecordLaunchPhase(
+      LaunchPhase phase,
+      LaunchTimeline::Clock::time_point when = LaunchTimeline::Clock::now());
+  void ResetLaunchTimeline();
+  [[nodiscard]] LaunchTimeline GetLaunchTimeline() const;
+  [[nodiscard]] std::shared_ptr<const OutputBuffer> GetOutput() const;
+  bool TerminateProcess();
+  bool KillProcess();
 
  protected:
+  bool StartProcess(const LaunchOptions& options, bool wait_for_exit);
+  bool Fail(const std::string& error);
+
   std::string id_;
   Type type_;
   std::string name_;
   std::string path_;
   std::map<std::string, std::string> metadata_;
+  std::vector<std::string> arguments_;
+  std::vector<std::string> dependencies_;
+  uint64_t dependency_revision_;
+  mutable std::mutex process_mutex_;
+  ProcessHandle process_;
+  int last_exit_code_;
+  std::string last_error_;
+  LaunchTimeline timeline_;
+  std::shared_ptr<OutputBuffer> output_;
 };
 
 class ApplicationItem : public LoafItem {
  public:
   explicit ApplicationItem(const std::string& id);
-  bool Execute() override;
+  using LoafItem::Execute;
+  bool Execute(bool wait_for_exit) override;
   [[nodiscard]] bool Validate() const override;
 };
 
 class FileItem : public LoafItem {
  public:
   explicit FileItem(const std::string& id);
-  bool Execute() override;
+  using LoafItem::Execute;
+  bool Execute(bool wait_for_exit) override;
   [[nodiscard]] bool Validate() const override;
 };
 
 class ConfigItem : public LoafItem {
  public:
   explicit ConfigItem(const std::string& id);
-  bool Execute() override;
+  using LoafItem::Execute;
+  bool Execute(bool wait_for_exit) override;
   [[nodiscard]] bool Validate() const override;
 };
 
 class ScriptItem : public LoafItem {
  public:
   explicit ScriptItem(const std::string& id);
-  bool Execute() override;
+  using LoafItem::Execute;
+  bool Execute(bool wait_for_exit) override;
   [[nodiscard]] bool Validate() const override;
 };
 
 class WebPageItem : public LoafItem {
  public:
   explicit WebPageItem(const std::string& id);
-  bool Execute() override;
+  using LoafItem::Execute;
+  bool Execute(bool wait_for_exit) override;
   [[nodiscard]] bool Validate() const override;
 };
 }  // namespace BreadBin
@@ -0,0 +1,44 @@
+#ifndef LOAF_TEXT_PARSER_H
+#define LOAF_TEXT_PARSER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "LoafBinaryFormat.h"
+
+namespace BreadBin {
+class Loaf;
+
+struct LoafParseError {
+  size_t line = 0;
+  size_t column = 0;
+  std::string message;
+
+  [[nodiscard]] std::string ToString() const;
+};
+
+class LoafTextParser {
+ public:
+  explicit LoafTextParser(std::string_view data);
+
+  bool Parse(Loaf* loaf);
+  bool ParseSummary(LoafSummary* summary);
+  [[nodiscard]] const LoafParseError& GetError() const;
+
+ private:
+  bool NextLine(std::string_view* line);
+  bool ExpectField(std::string_view prefix, std::string_view* value);
+  bool ParseCount(std::string_view text, size_t column, size_t* count);
+  bool ParseHeader(LoafSummary* summary, Loaf* loaf);
+  bool ParseItem(Loaf* loaf);
+  bool Fail(size_t column, std::string message);
+
+  std::string_view data_;
+  size_t position_;
+  size_t line_number_;
+  LoafParseError error_;
+};
+}  // namespace BreadBin
+
+#endif  // LOAF_TEXT_PARSER_H
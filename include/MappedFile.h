@@ -0,0 +1,30 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace BreadBin {
+class MappedFile {
+ public:
+  MappedFile();
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool Open(const std::string& filepath);
+  void Close();
+  [[nodiscard]] bool IsOpen() const;
+  [[nodiscard]] std::string_view GetData() const;
+
+ private:
+  const char* data_;
+  size_t size_;
+  bool open_;
+  bool mapped_;
+  std::string buffer_;
+};
+}  // namespace BreadBin
+
+#endif  // MAPPED_FILE_H
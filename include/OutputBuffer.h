@@ -0,0 +1,39 @@
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BreadBin {
+class OutputBuffer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr size_t k_default_capacity = 64 * 1024;
+
+  explicit OutputBuffer(size_t capacity = k_default_capacity);
+
+  void Append(std::string_view data);
+  [[nodiscard]] std::string ReadSince(uint64_t position,
+                                      uint64_t* next_position) const;
+  [[nodiscard]] std::string ReadAll() const;
+  [[nodiscard]] uint64_t GetTotalWritten() const;
+  [[nodiscard]] size_t GetCapacity() const;
+  [[nodiscard]] std::optional<Clock::time_point> GetFirstWriteTime() const;
+  void ResetFirstWriteTime();
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<char> storage_;
+  uint64_t total_written_;
+  std::optional<Clock::time_point> first_write_;
+};
+}  // namespace BreadBin
+
+#endif  // OUTPUT_BUFFER_H
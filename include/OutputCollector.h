@@ -0,0 +1,41 @@
+#ifndef OUTPUT_COLLECTOR_H
+#define OUTPUT_COLLECTOR_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "OutputBuffer.h"
+
+namespace BreadBin {
+class OutputCollector {
+ public:
+  static OutputCollector& Instance();
+  static bool IsSupported();
+
+  ~OutputCollector();
+  OutputCollector(const OutputCollector&) = delete;
+  OutputCollector& operator=(const OutputCollector&) = delete;
+
+  bool Add(int descriptor, std::shared_ptr<OutputBuffer> buffer);
+
+ private:
+  OutputCollector();
+
+  bool Start();
+  void Loop();
+  bool Drain(int descriptor, OutputBuffer& buffer);
+  void Remove(int descriptor);
+
+  std::thread thread_;
+  std::mutex mutex_;
+  std::unordered_map<int, std::shared_ptr<OutputBuffer>> sources_;
+  int epoll_descriptor_;
+  int wake_descriptor_;
+  bool stopping_;
+};
+}  // namespace BreadBin
+
+#endif  // OUTPUT_COLLECTOR_H
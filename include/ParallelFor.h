@@ -0,0 +1,43 @@
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace BreadBin {
+// Calls function(i) for every i in [0, count) on up to jobs threads, handing
+// out indices one at a time. A jobs value of 0 uses one thread per hardware
+// thread; with a single job everything runs on the calling thread.
+template <typename Function>
+void ParallelFor(size_t count, size_t jobs, Function function) {
+  if (jobs == 0) {
+    jobs = std::max(1u, std::thread::hardware_concurrency());
+  }
+  jobs = std::min(jobs, count);
+  if (jobs <= 1) {
+    for (size_t i = 0; i < count; ++i) {
+      function(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> workers;
+  workers.reserve(jobs);
+  for (size_t worker = 0; worker < jobs; ++worker) {
+    workers.emplace_back([&]() {
+      for (size_t i = next++; i < count; i = next++) {
+        function(i);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+}  // namespace BreadBin
+
+#endif  // PARALLEL_FOR_H
@@ -0,0 +1,72 @@
+#ifndef PROCESS_LAUNCHER_H
+#define PROCESS_LAUNCHER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BreadBin {
+using ProcessId = long;
+
+enum class IoClass { INHERIT = 0, REALTIME = 1, BEST_EFFORT = 2, IDLE = 3 };
+
+struct ResourceLimits {
+  std::vector<int> cpu_affinity;
+  bool set_nice = false;
+  int nice = 0;
+  IoClass io_class = IoClass::INHERIT;
+  int io_priority = 4;
+  uint64_t address_space_bytes = 0;
+  uint64_t open_files = 0;
+  std::string cgroup;
+
+  [[nodiscard]] bool IsEmpty() const;
+};
+
+struct LaunchOptions {
+  std::vector<std::string> arguments;
+  std::string working_directory;
+  bool discard_output = false;
+  int output_descriptor = -1;
+  ResourceLimits limits;
+};
+
+class ProcessHandle {
+ public:
+  ProcessHandle();
+  explicit ProcessHandle(ProcessId process_id);
+  ~ProcessHandle();
+  ProcessHandle(const ProcessHandle&) = delete;
+  ProcessHandle& operator=(const ProcessHandle&) = delete;
+  ProcessHandle(ProcessHandle&& other) noexcept;
+  ProcessHandle& operator=(ProcessHandle&& other) noexcept;
+
+  [[nodiscard]] bool IsValid() const;
+  [[nodiscard]] ProcessId GetProcessId() const;
+  [[nodiscard]] int GetPollDescriptor() const;
+  [[nodiscard]] int DuplicatePollDescriptor() const;
+  bool Terminate() const;
+  bool Kill() const;
+  bool TryWait(int* exit_code);
+  int Wait();
+  void Reset();
+
+ private:
+  ProcessId process_id_;
+  int poll_descriptor_;
+};
+
+class ProcessLauncher {
+ public:
+  static std::vector<std::string> SplitArguments(const std::string& arguments);
+  static bool IsExecutableFile(const std::string& path);
+  static std::string FindExecutable(const std::string& name);
+  static ProcessId Spawn(const LaunchOptions& options, std::string* error);
+  static bool CreateOutputPipe(int* read_descriptor, int* write_descriptor);
+  static void CloseDescriptor(int descriptor);
+  static int WaitForExit(ProcessId process_id);
+  static void WaitUntilExited(ProcessId process_id);
+};
+}  // namespace BreadBin
+
+#endif  // PROCESS_LAUNCHER_H
\ No newline at end of file
@@ -0,0 +1,70 @@
+#ifndef PROCESS_MONITOR_H
+#define PROCESS_MONITOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "LoafItem.h"
+
+namespace BreadBin {
+enum class ItemState { IDLE, RUNNING, EXITED, FAILED, RESTARTING };
+
+struct ItemEvent {
+  std::string item_id;
+  ItemState state = ItemState::IDLE;
+  int exit_code = 0;
+  int restart_count = 0;
+};
+
+class ProcessMonitor {
+ public:
+  using Callback = std::function<void(const ItemEvent&)>;
+  using Task = std::function<void()>;
+
+  explicit ProcessMonitor(Callback callback);
+  ~ProcessMonitor();
+  ProcessMonitor(const ProcessMonitor&) = delete;
+  ProcessMonitor& operator=(const ProcessMonitor&) = delete;
+
+  bool Start();
+  void Stop();
+  bool Watch(const std::shared_ptr<LoafItem>& item);
+  bool ScheduleAfter(std::chrono::milliseconds delay, Task task);
+  void CancelScheduled();
+  [[nodiscard]] bool IsActive() const;
+
+ private:
+  struct Watched {
+    std::weak_ptr<LoafItem> item;
+    ProcessId process_id;
+    int descriptor;
+  };
+
+  struct Timer {
+    int descriptor;
+    Task task;
+  };
+
+  void Loop();
+  void Remove(uint64_t key);
+  bool TakeTimer(uint64_t key, Task* task);
+
+  Callback callback_;
+  std::thread thread_;
+  std::mutex mutex_;
+  std::unordered_map<uint64_t, Watched> watched_;
+  std::unordered_map<uint64_t, Timer> timers_;
+  uint64_t next_key_;
+  int epoll_descriptor_;
+  int wake_descriptor_;
+  bool stopping_;
+};
+}  // namespace BreadBin
+
+#endif  // PROCESS_MONITOR_H
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef READINESS_PROBE_H
+#define READINESS_PROBE_H
+
+#include <cstdint>
+#include <string>
+
+#include "LoafItem.h"
+
+namespace BreadBin {
+struct ReadinessSpec {
+  std::string file;
+  int port = 0;
+  std::string log_file;
+  std::string log_match;
+  int delay_ms = 0;
+  int timeout_ms = 30000;  // 0 or less waits without a timeout
+
+  [[nodiscard]] bool IsEmpty() const;
+  static ReadinessSpec FromItem(const LoafItem& item);
+};
+
+class ReadinessProbe {
+ public:
+  explicit ReadinessProbe(ReadinessSpec spec);
+
+  bool Wait(LoafItem& item, int cancel_descriptor);
+  [[nodiscard]] const std::string& GetError() const;
+
+ private:
+  [[nodiscard]] bool IsSatisfied();
+  [[nodiscard]] bool CheckFile() const;
+  [[nodiscard]] bool CheckPort() const;
+  [[nodiscard]] bool CheckLog();
+
+  ReadinessSpec spec_;
+  uint64_t log_offset_;
+  std::string log_partial_line_;
+  bool log_matched_;
+  bool delay_elapsed_;
+  std::string error_;
+};
+}  // namespace BreadBin
+
+#endif  // READINESS_PROBE_H
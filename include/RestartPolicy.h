@@ -0,0 +1,37 @@
+#ifndef RESTART_POLICY_H
+#define RESTART_POLICY_H
+
+#include <chrono>
+#include <deque>
+
+#include "LoafItem.h"
+
+namespace BreadBin {
+enum class RestartMode { NEVER, ON_FAILURE, ALWAYS };
+
+struct RestartPolicy {
+  RestartMode mode = RestartMode::NEVER;
+  int max_restarts = 5;
+  std::chrono::milliseconds window{60000};
+  std::chrono::milliseconds initial_backoff{500};
+  std::chrono::milliseconds max_backoff{30000};
+
+  [[nodiscard]] bool ShouldRestart(int exit_code) const;
+  static RestartPolicy FromItem(const LoafItem& item);
+};
+
+class RestartTracker {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  bool NextDelay(const RestartPolicy& policy, Clock::time_point now,
+                 std::chrono::milliseconds* delay);
+  [[nodiscard]] int GetRestartCount() const;
+
+ private:
+  std::deque<Clock::time_point> recent_;
+  int restart_count_ = 0;
+};
+}  // namespace BreadBin
+
+#endif  // RESTART_POLICY_H
@@ -0,0 +1,55 @@
+#ifndef VALIDATION_ENGINE_H
+#define VALIDATION_ENGINE_H
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Loaf.h"
+
+namespace BreadBin {
+struct ValidationIssue {
+  size_t loaf_index = 0;
+  std::string item_id;
+  std::string path;
+  std::string reason;
+};
+
+struct ValidationReport {
+  size_t item_count = 0;
+  size_t unique_checks = 0;
+  size_t cache_hits = 0;
+  std::vector<ValidationIssue> broken;
+};
+
+class ValidationEngine {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr std::chrono::milliseconds k_default_ttl{5000};
+
+  // A max_workers of 0 uses one thread per hardware thread.
+  explicit ValidationEngine(size_t max_workers = 0,
+                            std::chrono::milliseconds ttl = k_default_ttl);
+
+  ValidationReport Validate(const std::vector<std::shared_ptr<Loaf>>& loafs);
+  void ClearCache();
+
+ private:
+  struct CachedResult {
+    bool valid;
+    Clock::time_point checked;
+  };
+
+  size_t max_workers_;
+  std::chrono::milliseconds ttl_;
+  std::mutex cache_mutex_;
+  std::unordered_map<std::string, CachedResult> cache_;
+};
+}  // namespace BreadBin
+
+#endif  // VALIDATION_ENGINE_H
@@ -0,0 +1,37 @@
+#ifndef BATCHCOMMANDS_H
+#define BATCHCOMMANDS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "cli/ReportWriter.h"
+
+namespace BreadBin::Cli {
+struct BatchOptions {
+  std::vector<std::string> files;
+  size_t jobs = 0;
+  std::string socket_path;
+  std::string convert_format;
+  std::string output_path;
+};
+
+class BatchCommands {
+ public:
+  static bool IsCommand(const std::string& command);
+  static std::vector<FileReport> Run(const std::string& command,
+                                     const BatchOptions& options);
+
+ private:
+  static std::vector<FileReport> ValidateAll(const BatchOptions& options);
+  static FileReport Convert(const std::string& file,
+                            const BatchOptions& options);
+  static FileReport List(const std::string& file);
+  static FileReport Stats(const std::string& file);
+  static FileReport Control(const std::string& command,
+                            const std::string& file,
+                            const BatchOptions& options);
+};
+}  // namespace BreadBin::Cli
+
+#endif  // BATCHCOMMANDS_H
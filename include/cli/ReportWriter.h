@@ -0,0 +1,35 @@
+#ifndef REPORTWRITER_H
+#define REPORTWRITER_H
+
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace BreadBin::Cli {
+using FieldValue =
+    std::variant<std::string, int64_t, bool, std::vector<std::string>>;
+
+struct Field {
+  std::string key;
+  FieldValue value;
+};
+
+struct FileReport {
+  std::string file;
+  bool ok = true;
+  std::vector<Field> fields;
+
+  void Add(std::string key, FieldValue value);
+  void AddError(const std::string& error);
+};
+
+class ReportWriter {
+ public:
+  static std::string ToJson(const std::string& command,
+                            const std::vector<FileReport>& reports);
+  static std::string ToText(const std::vector<FileReport>& reports);
+};
+}  // namespace BreadBin::Cli
+
+#endif  // REPORTWRITER_H
@@ -0,0 +1,69 @@
+#ifndef LOAFDAEMON_H
+#define LOAFDAEMON_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "ControlProtocol.h"
+#include "Loaf.h"
+
+namespace BreadBin::Daemon {
+class LoafDaemon {
+ public:
+  explicit LoafDaemon(std::string socket_path);
+  ~LoafDaemon();
+  LoafDaemon(const LoafDaemon&) = delete;
+  LoafDaemon& operator=(const LoafDaemon&) = delete;
+
+  bool Start();
+  void Run();
+  bool StartLoaf(const std::string& filepath, std::string* error);
+  [[nodiscard]] const std::string& GetLastError() const;
+
+ private:
+  struct ItemEvents {
+    std::mutex mutex;
+    std::unordered_map<std::string, ItemEvent> latest;
+  };
+
+  struct ManagedLoaf {
+    std::shared_ptr<Loaf> loaf;
+    std::shared_ptr<ItemEvents> events;
+    std::thread stopper;
+    std::shared_ptr<std::atomic<bool>> stopped;
+  };
+
+  struct Connection {
+    std::string input;
+    std::string output;
+  };
+
+  ControlResponse Handle(const ControlRequest& request);
+  ControlResponse Status(const std::string& target) const;
+  bool StopLoaf(const std::string& id, std::string* error);
+  void StopAll();
+  void ReapStopped();
+  void Accept();
+  void ReadConnection(int descriptor);
+  void FlushConnection(int descriptor);
+  void CloseConnection(int descriptor);
+  void Wake();
+
+  std::string socket_path_;
+  std::string last_error_;
+  std::map<std::string, ManagedLoaf> loafs_;
+  std::unordered_map<int, Connection> connections_;
+  int listen_descriptor_;
+  int epoll_descriptor_;
+  int signal_descriptor_;
+  int wake_descriptor_;
+  bool shutting_down_;
+};
+}  // namespace BreadBin::Daemon
+
+#endif  // LOAFDAEMON_H
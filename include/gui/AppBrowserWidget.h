@@ -5,12 +5,17 @@
 #include <QLabel>
 #include <QLineEdit>
 #include <QListWidget>
+#include <QProgressBar>
 #include <QPushButton>
 #include <QTextEdit>
 #include <QWidget>
+#include <atomic>
 #include <memory>
+#include <optional>
+#include <thread>
 
 #include "AppDiscovery.h"
+#include "AppWatcher.h"
 
 namespace BreadBin::GUI {
 class AppBrowserWidget : public QWidget {
@@ -21,14 +26,20 @@ class AppBrowserWidget : public QWidget {
   ~AppBrowserWidget() override;
 
   void RefreshApplications();
-  [[nodiscard]] const AppInfo* GetSelectedApplication() const;
+  [[nodiscard]] std::optional<AppInfo> GetSelectedApplication() const;
 
  signals:
   void ApplicationSelected(const AppInfo& app_info);
   void AddApplicationRequested(const AppInfo& app_info);
+  void scanProgress(int completed, int total, int found);
+  void scanFinished();
+  void applicationsChanged();
 
  private slots:
   void OnScanClicked();
+  void OnScanProgress(int completed, int total, int found);
+  void OnScanFinished();
+  void OnApplicationsChanged();
   void OnSearchChanged(const QString& text);
   void OnCategoryChanged(const QString& category);
   void OnApplicationSelected();
@@ -36,19 +47,26 @@ class AppBrowserWidget : public QWidget {
 
  private:
   void SetupUI();
+  void StartScan();
   void ConnectSignals();
   void UpdateApplicationList();
   void UpdateApplicationDetails(const AppInfo& app_info);
   void PopulateCategories() const;
 
   std::shared_ptr<AppDiscovery> discovery_;
-  std::vector<AppInfo> filtered_apps_;
+  std::unique_ptr<AppDiscovery> scanner_;
+  std::unique_ptr<AppWatcher> watcher_;
+  std::thread scan_thread_;
+  std::atomic<bool> scan_cancelled_;
+  bool rescan_pending_;
+  std::vector<size_t> filtered_indices_;
   QLineEdit* search_edit_;
   QComboBox* category_combo_;
   QListWidget* app_list_;
   QTextEdit* details_text_;
   QPushButton* scan_button_;
   QPushButton* add_button_;
+  QProgressBar* scan_progress_;
   QLabel* status_label_;
 };
 }  // namespace BreadBin::GUI
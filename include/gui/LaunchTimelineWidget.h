@@ -0,0 +1,41 @@
+#ifndef LAUNCHTIMELINEWIDGET_H
+#define LAUNCHTIMELINEWIDGET_H
+
+#include <QSet>
+#include <QString>
+#include <QWidget>
+#include <vector>
+
+#include "LaunchTrace.h"
+
+namespace BreadBin::GUI {
+class LaunchTimelineWidget : public QWidget {
+  Q_OBJECT
+
+ public:
+  explicit LaunchTimelineWidget(QWidget* parent = nullptr);
+
+  void SetTrace(const LaunchTrace& trace, const QSet<QString>& critical_path);
+  void Clear();
+  [[nodiscard]] QSize sizeHint() const override;
+
+ protected:
+  void paintEvent(QPaintEvent* event) override;
+
+ private:
+  struct Row {
+    QString label;
+    double queued = -1.0;
+    double spawn_start = -1.0;
+    double spawn_done = -1.0;
+    double first_output = -1.0;
+    double ready = -1.0;
+    bool critical = false;
+  };
+
+  std::vector<Row> rows_;
+  double span_ms_;
+};
+}  // namespace BreadBin::GUI
+
+#endif  // LAUNCHTIMELINEWIDGET_H
@@ -8,8 +8,12 @@
 #include <QString>
 #include <QTextEdit>
 #include <QWidget>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include "ValidationEngine.h"
+
 namespace BreadBin::GUI {
 struct LoafFileInfo {
   QString filepath;
@@ -17,6 +21,8 @@ struct LoafFileInfo {
   QString description;
   int itemCount;
   QString lastModified;
+  int brokenCount;
+  QStringList brokenItems;
 };
 
 class LoafBrowserWidget : public QWidget {
@@ -32,6 +38,7 @@ class LoafBrowserWidget : public QWidget {
  signals:
   void LoafSelected(const QString& filepath);
   void LoafOpened(const QString& filepath);
+  void validationFinished();
 
  private slots:
   void OnRefreshClicked();
@@ -39,6 +46,7 @@ class LoafBrowserWidget : public QWidget {
   void OnLoafSelected();
   void OnOpenClicked();
   void OnDeleteClicked();
+  void OnValidationFinished();
 
  private:
   void SetupUI();
@@ -46,8 +54,14 @@ class LoafBrowserWidget : public QWidget {
   void UpdateLoafList();
   void UpdateLoafPreview(const LoafFileInfo& info);
   void ScanForLoafFiles();
+  void StartValidation();
   LoafFileInfo LoadLoafInfo(const QString& filepath);
 
+  ValidationEngine validation_engine_;
+  std::thread validation_thread_;
+  bool revalidate_pending_;
+  std::vector<std::string> validated_paths_;
+  std::vector<QStringList> validation_results_;
   std::vector<LoafFileInfo> loaf_files_;
   std::vector<LoafFileInfo> filtered_files_;
   QStringList search_paths_;
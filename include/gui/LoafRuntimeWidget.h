@@ -1,14 +1,19 @@
 #ifndef LOAFRUNTIMEWIDGET_H
 #define LOAFRUNTIMEWIDGET_H
 
+#include <QHash>
 #include <QLabel>
 #include <QListWidget>
+#include <QPlainTextEdit>
 #include <QPushButton>
+#include <QString>
 #include <QTimer>
 #include <QWidget>
+#include <cstdint>
 #include <memory>
 
 #include "Loaf.h"
+#include "gui/LaunchTimelineWidget.h"
 
 namespace BreadBin::GUI {
 class LoafRuntimeWidget : public QWidget {
@@ -23,17 +28,33 @@ class LoafRuntimeWidget : public QWidget {
  signals:
   void loafStarted();
   void loafStopped();
+  void itemStatusChanged(const QString& item_id, int state, int exit_code,
+                         int restart_count);
+  void itemLaunched(const QString& item_id, bool launched, qint64 latency_us,
+                    const QString& error);
+  void launchFinished(bool success, const QString& error);
 
  private slots:
   void OnRunLoaf();
   void OnStopLoaf();
   void OnRefreshStatus();
-  void UpdateStatus();
+  void OnItemStatusChanged(const QString& item_id, int state, int exit_code,
+                           int restart_count);
+  void OnItemLaunched(const QString& item_id, bool launched,
+                      qint64 latency_us, const QString& error);
+  void OnLaunchFinished(bool success, const QString& error);
+  void OnExportTrace();
+  void OnSelectedItemChanged();
+  void OnTailOutput();
 
  private:
   void SetupUI();
   void ConnectSignals();
   void RefreshLoafStatus();
+  void SetControlsRunning(bool running);
+  void RefreshTimeline();
+  void UpdateItemRow(const QString& item_id);
+  [[nodiscard]] static QString DescribeState(ItemState state, int exit_code);
 
   std::shared_ptr<Loaf> current_loaf_;
   QLabel* loaf_name_label_;
@@ -42,7 +63,18 @@ class LoafRuntimeWidget : public QWidget {
   QPushButton* run_button_;
   QPushButton* stop_button_;
   QPushButton* refresh_button_;
-  QTimer* status_timer_;
+  LaunchTimelineWidget* timeline_widget_;
+  QPushButton* export_trace_button_;
+  QPlainTextEdit* output_view_;
+  QTimer* output_timer_;
+  QString output_item_id_;
+  uint64_t output_position_;
+  QHash<QString, int> item_rows_;
+  QHash<QString, QString> item_states_;
+  QHash<QString, QString> item_details_;
+  QHash<QString, int> item_restarts_;
+  QHash<QString, int> item_last_exit_codes_;
+  bool launching_;
 };
 }  // namespace BreadBin::GUI
 
@@ -0,0 +1,336 @@
+#include "AppCache.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#include "AtomicFileWriter.h"
+#include "ByteCodec.h"
+
+namespace BreadBin {
+namespace {
+constexpr char k_magic[8] = {'B', 'B', 'A', 'P', 'P', 'S', '\0', '\n'};
+constexpr size_t k_header_size = sizeof(k_magic) + 6 * sizeof(uint32_t);
+constexpr size_t k_reference_size = 2 * sizeof(uint32_t);
+constexpr size_t k_source_size = k_reference_size + 4 * sizeof(uint64_t);
+constexpr size_t k_field_count = 5;
+constexpr size_t k_entry_size =
+    k_field_count * k_reference_size + 4 * sizeof(uint32_t);
+
+enum Field { NAME, EXECUTABLE, DESCRIPTION, ICON_PATH, CATEGORY };
+
+uint32_t ReadU32(const char* data) {
+  return static_cast<uint32_t>(ReadInteger(data, sizeof(uint32_t)));
+}
+
+uint64_t ReadU64(const char* data) {
+  return ReadInteger(data, sizeof(uint64_t));
+}
+
+class StringTable {
+ public:
+  void WriteReference(std::string& buffer, const std::string& value) {
+    auto [it, inserted] = offsets_.emplace(value, data_.size());
+    if (inserted) {
+      data_ += value;
+    }
+    WriteInteger(buffer, it->second, sizeof(uint32_t));
+    WriteInteger(buffer, value.size(), sizeof(uint32_t));
+  }
+
+  [[nodiscard]] const std::string& GetData() const { return data_; }
+
+ private:
+  std::unordered_map<std::string, size_t> offsets_;
+  std::string data_;
+};
+
+FileStamp ReadSourceStamp(const char* record) {
+  FileStamp stamp;
+  record += k_reference_size;
+  stamp.device = ReadU64(record);
+  stamp.inode = ReadU64(record + 8);
+  stamp.modified_ns = static_cast<int64_t>(ReadU64(record + 16));
+  stamp.size = ReadU64(record + 24);
+  return stamp;
+}
+}  // namespace
+
+AppCache::Entry::Entry(const AppCache* cache, const char* record)
+    : cache_(cache), record_(record) {}
+
+std::string_view AppCache::Entry::GetName() const {
+  return cache_->GetString(record_ + NAME * k_reference_size);
+}
+
+std::string_view AppCache::Entry::GetExecutable() const {
+  return cache_->GetString(record_ + EXECUTABLE * k_reference_size);
+}
+
+std::string_view AppCache::Entry::GetDescription() const {
+  return cache_->GetString(record_ + DESCRIPTION * k_reference_size);
+}
+
+std::string_view AppCache::Entry::GetIconPath() const {
+  return cache_->GetString(record_ + ICON_PATH * k_reference_size);
+}
+
+std::string_view AppCache::Entry::GetCategory() const {
+  return cache_->GetString(record_ + CATEGORY * k_reference_size);
+}
+
+size_t AppCache::Entry::GetFlagCount() const {
+  return ReadU32(record_ + k_field_count * k_reference_size + 4);
+}
+
+std::string_view AppCache::Entry::GetFlag(size_t index) const {
+  const size_t first = ReadU32(record_ + k_field_count * k_reference_size);
+  return cache_->GetString(cache_->references_ +
+                           (first + index) * k_reference_size);
+}
+
+size_t AppCache::Entry::GetMetadataCount() const {
+  return ReadU32(record_ + k_field_count * k_reference_size + 12);
+}
+
+std::pair<std::string_view, std::string_view> AppCache::Entry::GetMetadata(
+    size_t index) const {
+  const size_t first = ReadU32(record_ + k_field_count * k_reference_size + 8);
+  const char* reference =
+      cache_->references_ + (first + 2 * index) * k_reference_size;
+  return {cache_->GetString(reference),
+          cache_->GetString(reference + k_reference_size)};
+}
+
+AppInfo AppCache::Entry::ToAppInfo() const {
+  AppInfo info{std::string(GetName()), std::string(GetExecutable())};
+  info.description = GetDescription();
+  info.icon_path = GetIconPath();
+  info.category = GetCategory();
+  info.common_flags.reserve(GetFlagCount());
+  for (size_t i = 0; i < GetFlagCount(); ++i) {
+    info.common_flags.emplace_back(GetFlag(i));
+  }
+  for (size_t i = 0; i < GetMetadataCount(); ++i) {
+    const auto [key, value] = GetMetadata(i);
+    info.metadata.emplace(key, value);
+  }
+  return info;
+}
+
+AppCache::AppCache()
+    : sources_(nullptr),
+      entries_(nullptr),
+      references_(nullptr),
+      strings_(nullptr),
+      source_count_(0),
+      entry_count_(0),
+      reference_count_(0),
+      string_size_(0) {}
+
+AppCache::~AppCache() = default;
+
+bool AppCache::Open(const std::string& filepath) {
+  Close();
+  if (!file_.Open(filepath)) {
+    return false;
+  }
+
+  const std::string_view data = file_.GetData();
+  if (data.size() < k_header_size ||
+      std::memcmp(data.data(), k_magic, sizeof(k_magic)) != 0 ||
+      ReadU32(data.data() + sizeof(k_magic)) != k_version) {
+    Close();
+    return false;
+  }
+
+  const char* header = data.data() + sizeof(k_magic) + sizeof(uint32_t);
+  const uint64_t source_count = ReadU32(header);
+  const uint64_t entry_count = ReadU32(header + 4);
+  const uint64_t reference_count = ReadU32(header + 8);
+  const uint64_t string_size = ReadU32(header + 12);
+  if (k_header_size + source_count * k_source_size +
+          entry_count * k_entry_size + reference_count * k_reference_size +
+          string_size !=
+      data.size()) {
+    Close();
+    return false;
+  }
+
+  sources_ = data.data() + k_header_size;
+  entries_ = sources_ + source_count * k_source_size;
+  references_ = entries_ + entry_count * k_entry_size;
+  strings_ = references_ + reference_count * k_reference_size;
+  source_count_ = source_count;
+  entry_count_ = entry_count;
+  reference_count_ = reference_count;
+  string_size_ = string_size;
+
+  auto is_valid_reference = [this](const char* reference) {
+    return static_cast<uint64_t>(ReadU32(reference)) +
+               ReadU32(reference + 4) <=
+           string_size_;
+  };
+  bool valid = true;
+  for (size_t i = 0; valid && i < source_count_; ++i) {
+    valid = is_valid_reference(sources_ + i * k_source_size);
+  }
+  for (size_t i = 0; valid && i < reference_count_; ++i) {
+    valid = is_valid_reference(references_ + i * k_reference_size);
+  }
+  for (size_t i = 0; valid && i < entry_count_; ++i) {
+    const char* record = entries_ + i * k_entry_size;
+    for (size_t field = 0; valid && field < k_field_count; ++field) {
+      valid = is_valid_reference(record + field * k_reference_size);
+    }
+    const char* lists = record + k_field_count * k_reference_size;
+    valid = valid &&
+            static_cast<uint64_t>(ReadU32(lists)) + ReadU32(lists + 4) <=
+                reference_count_ &&
+            static_cast<uint64_t>(ReadU32(lists + 8)) +
+                    2 * static_cast<uint64_t>(ReadU32(lists + 12)) <=
+                reference_count_;
+  }
+  if (!valid) {
+    Close();
+  }
+  return valid;
+}
+
+void AppCache::Close() {
+  file_.Close();
+  sources_ = nullptr;
+  entries_ = nullptr;
+  references_ = nullptr;
+  strings_ = nullptr;
+  source_count_ = 0;
+  entry_count_ = 0;
+  reference_count_ = 0;
+  string_size_ = 0;
+}
+
+bool AppCache::IsOpen() const { return file_.IsOpen(); }
+
+size_t AppCache::GetSize() const { return entry_count_; }
+
+AppCache::Entry AppCache::GetEntry(size_t index) const {
+  return Entry(this, entries_ + index * k_entry_size);
+}
+
+bool AppCache::IsFresh(const std::vector<std::string>& directories) const {
+  if (!IsOpen() || directories.size() != source_count_) {
+    return false;
+  }
+  for (size_t i = 0; i < source_count_; ++i) {
+    const char* record = sources_ + i * k_source_size;
+    if (GetString(record) != directories[i]) {
+      return false;
+    }
+    FileStamp stamp;
+    ReadStamp(directories[i], &stamp);
+    if (!(stamp == ReadSourceStamp(record))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string_view AppCache::GetString(const char* reference) const {
+  return std::string_view(strings_ + ReadU32(reference),
+                          ReadU32(reference + 4));
+}
+
+bool AppCache::Write(const std::string& filepath,
+                     const std::vector<AppInfo>& applications,
+                     const std::vector<SourceFingerprint>& sources) {
+  StringTable strings;
+  std::string source_records;
+  for (const auto& source : sources) {
+    strings.WriteReference(source_records, source.directory);
+    WriteInteger(source_records, source.stamp.device, sizeof(uint64_t));
+    WriteInteger(source_records, source.stamp.inode, sizeof(uint64_t));
+    WriteInteger(source_records,
+                 static_cast<uint64_t>(source.stamp.modified_ns),
+                 sizeof(uint64_t));
+    WriteInteger(source_records, source.stamp.size, sizeof(uint64_t));
+  }
+
+  std::string entry_records;
+  std::string references;
+  size_t reference_count = 0;
+  for (const auto& app : applications) {
+    strings.WriteReference(entry_records, app.name);
+    strings.WriteReference(entry_records, app.executable);
+    strings.WriteReference(entry_records, app.description);
+    strings.WriteReference(entry_records, app.icon_path);
+    strings.WriteReference(entry_records, app.category);
+
+    WriteInteger(entry_records, reference_count, sizeof(uint32_t));
+    WriteInteger(entry_records, app.common_flags.size(), sizeof(uint32_t));
+    for (const auto& flag : app.common_flags) {
+      strings.WriteReference(references, flag);
+    }
+    reference_count += app.common_flags.size();
+
+    WriteInteger(entry_records, reference_count, sizeof(uint32_t));
+    WriteInteger(entry_records, app.metadata.size(), sizeof(uint32_t));
+    for (const auto& [key, value] : app.metadata) {
+      strings.WriteReference(references, key);
+      strings.WriteReference(references, value);
+    }
+    reference_count += 2 * app.metadata.size();
+  }
+
+  std::string output(k_magic, sizeof(k_magic));
+  WriteInteger(output, k_version, sizeof(uint32_t));
+  WriteInteger(output, sources.size(), sizeof(uint32_t));
+  WriteInteger(output, applications.size(), sizeof(uint32_t));
+  WriteInteger(output, reference_count, sizeof(uint32_t));
+  WriteInteger(output, strings.GetData().size(), sizeof(uint32_t));
+  WriteInteger(output, 0, sizeof(uint32_t));
+  output += source_records;
+  output += entry_records;
+  output += references;
+  output += strings.GetData();
+  return AtomicFileWriter::WriteFile(filepath, output, SyncPolicy::NONE);
+}
+
+bool AppCache::ReadStamp(const std::string& path, FileStamp* stamp) {
+  *stamp = FileStamp();
+#ifdef _WIN32
+  std::error_code error_code;
+  const auto modified = std::filesystem::last_write_time(path, error_code);
+  if (error_code) {
+    return false;
+  }
+  stamp->modified_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           modified.time_since_epoch())
+                           .count();
+  const auto size = std::filesystem::file_size(path, error_code);
+  stamp->size = error_code ? 0 : size;
+  return true;
+#else
+  struct stat status {};
+  if (stat(path.c_str(), &status) != 0) {
+    return false;
+  }
+#ifdef __APPLE__
+  const auto& modified = status.st_mtimespec;
+#else
+  const auto& modified = status.st_mtim;
+#endif
+  stamp->device = static_cast<uint64_t>(status.st_dev);
+  stamp->inode = static_cast<uint64_t>(status.st_ino);
+  stamp->modified_ns = static_cast<int64_t>(modified.tv_sec) * 1000000000 +
+                       modified.tv_nsec;
+  stamp->size = static_cast<uint64_t>(status.st_size);
+  return true;
+#endif
+}
+
+}  // namespace BreadBin
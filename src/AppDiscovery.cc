@@ -1,63 +1,426 @@
 #include "AppDiscovery.h"
 
 #include <algorithm>
-#include <cctype>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 #ifdef _WIN32
 #include <shlobj.h>
 #include <windows.h>
 #elif defined(__APPLE__)
 #include <CoreFoundation/CoreFoundation.h>
-#elif defined(__linux__)
-#include <sys/stat.h>
-#include <unistd.h>
 #endif
 
+#include "AppCache.h"
+#include "AppSearchIndex.h"
+#include "ParallelFor.h"
+#include "ProcessLauncher.h"
+
 namespace BreadBin {
+namespace {
+constexpr size_t k_progress_interval = 32;
 
-AppDiscovery::AppDiscovery() = default;
+enum class SourceKind { DESKTOP_ENTRIES, BUNDLES, SHORTCUTS, EXECUTABLES };
 
-AppDiscovery::~AppDiscovery() = default;
+struct ScanSource {
+  std::string directory;
+  SourceKind kind;
+};
 
-size_t AppDiscovery::ScanSystem() {
-  clear();
+struct PathExecutable {
+  AppInfo info;
+  std::string canonical_path;
+};
+
+struct SourceListing {
+  std::vector<std::string> desktop_files;
+  std::vector<AppInfo> applications;
+  std::vector<PathExecutable> executables;
+};
+
+struct CachedSource {
+  FileStamp stamp;
+  std::shared_ptr<const SourceListing> listing;
+};
+
+struct CachedDesktopFile {
+  FileStamp stamp;
+  AppInfo info;
+};
+
+std::vector<std::string> SplitSearchPath(const char* value,
+                                         const char* fallback) {
+#ifdef _WIN32
+  constexpr char k_delimiter = ';';
+#else
+  constexpr char k_delimiter = ':';
+#endif
+  std::vector<std::string> directories;
+  std::istringstream stream(value && *value ? value : fallback);
+  std::string directory;
+  while (std::getline(stream, directory, k_delimiter)) {
+    if (!directory.empty()) {
+      directories.push_back(directory);
+    }
+  }
+  return directories;
+}
+
+void AddSource(std::vector<ScanSource>* sources,
+               const std::string& directory, SourceKind kind) {
+  std::filesystem::path normal =
+      std::filesystem::path(directory).lexically_normal();
+  if (!normal.has_filename() && normal.has_relative_path()) {
+    normal = normal.parent_path();
+  }
+  std::string normalized = normal.string();
+  for (const auto& source : *sources) {
+    if (source.directory == normalized && source.kind == kind) {
+      return;
+    }
+  }
+  sources->push_back(ScanSource{std::move(normalized), kind});
+}
 
+// Drops sources that name the same directory through a symlink, keeping the
+// earlier (higher precedence) one.
+void RemoveAliasedSources(std::vector<ScanSource>* sources) {
+  std::vector<FileStamp> seen;
+  std::erase_if(*sources, [&seen](const ScanSource& source) {
+    FileStamp stamp;
+    if (!AppCache::ReadStamp(source.directory, &stamp)) {
+      return false;
+    }
+    const bool aliased =
+        std::any_of(seen.begin(), seen.end(), [&stamp](const FileStamp& other) {
+          return other.device == stamp.device && other.inode == stamp.inode;
+        });
+    if (!aliased) {
+      seen.push_back(stamp);
+    }
+    return aliased;
+  });
+}
+
+// Sources are returned in precedence order: for desktop entries the user's
+// data directory comes first, as in the XDG base directory spec.
+std::vector<ScanSource> GetScanSources() {
+  std::vector<ScanSource> sources;
+  const std::string home = getenv("HOME") ? getenv("HOME") : "";
 #ifdef __linux__
-  ScanLinuxApplications();
+  const char* data_home = getenv("XDG_DATA_HOME");
+  AddSource(&sources,
+            (data_home && *data_home ? std::string(data_home)
+                                     : home + "/.local/share") +
+                "/applications",
+            SourceKind::DESKTOP_ENTRIES);
+  for (const auto& directory : SplitSearchPath(getenv("XDG_DATA_DIRS"),
+                                               "/usr/local/share:/usr/share")) {
+    AddSource(&sources, directory + "/applications",
+              SourceKind::DESKTOP_ENTRIES);
+  }
+  AddSource(&sources, home + "/.local/share/applications",
+            SourceKind::DESKTOP_ENTRIES);
+  AddSource(&sources, "/usr/local/share/applications",
+            SourceKind::DESKTOP_ENTRIES);
+  AddSource(&sources, "/usr/share/applications", SourceKind::DESKTOP_ENTRIES);
 #elif defined(_WIN32)
-  ScanWindowsApplications();
+  CHAR path[MAX_PATH];
+  if (SUCCEEDED(SHGetFolderPathA(NULL, CSIDL_COMMON_PROGRAMS, NULL, 0, path))) {
+    AddSource(&sources, path, SourceKind::SHORTCUTS);
+  }
+  if (SUCCEEDED(SHGetFolderPathA(NULL, CSIDL_PROGRAMS, NULL, 0, path))) {
+    AddSource(&sources, path, SourceKind::SHORTCUTS);
+  }
 #elif defined(__APPLE__)
-  ScanMacOSApplications();
+  AddSource(&sources, "/Applications", SourceKind::BUNDLES);
+  AddSource(&sources, home + "/Applications", SourceKind::BUNDLES);
 #endif
+  for (const auto& directory : SplitSearchPath(getenv("PATH"), "")) {
+    AddSource(&sources, directory, SourceKind::EXECUTABLES);
+  }
+  RemoveAliasedSources(&sources);
+  return sources;
+}
 
-  ScanPathEnvironment();
+AppInfo MakeApplication(const std::filesystem::path& path, std::string name,
+                        const char* category) {
+  AppInfo info(std::move(name), path.string());
+  info.category = category;
+  return info;
+}
 
-  return applications_.size();
+void ListEntry(const std::filesystem::directory_entry& entry,
+               SourceKind kind, const std::filesystem::path& canonical_directory,
+               SourceListing* listing) {
+  const auto& path = entry.path();
+  std::error_code error_code;
+  switch (kind) {
+    case SourceKind::DESKTOP_ENTRIES:
+      if (path.extension() == ".desktop") {
+        listing->desktop_files.push_back(path.string());
+      }
+      break;
+    case SourceKind::BUNDLES:
+      if (path.extension() == ".app") {
+        listing->applications.push_back(
+            MakeApplication(path, path.stem().string(), "Application"));
+      }
+      break;
+    case SourceKind::SHORTCUTS:
+      if (path.extension() == ".lnk") {
+        listing->applications.push_back(
+            MakeApplication(path, path.stem().string(), "Application"));
+      }
+      break;
+    case SourceKind::EXECUTABLES: {
+      const auto status = entry.status(error_code);
+      if (!error_code && std::filesystem::is_regular_file(status) &&
+          (status.permissions() & std::filesystem::perms::owner_exec) !=
+              std::filesystem::perms::none) {
+        std::filesystem::path canonical_path =
+            entry.is_symlink(error_code)
+                ? std::filesystem::canonical(path, error_code)
+                : canonical_directory / path.filename();
+        listing->executables.push_back(PathExecutable{
+            MakeApplication(path, path.filename().string(), "Command-Line"),
+            error_code ? std::string() : canonical_path.string()});
+      }
+      break;
+    }
+  }
 }
 
-void AppDiscovery::ScanLinuxApplications() {
-  std::vector<std::string> app_dirs = {
-      "/usr/share/applications", "/usr/local/share/applications",
-      std::string(getenv("HOME") ? getenv("HOME") : "") +
-          "/.local/share/applications"};
+std::string GetBaseName(const std::string& path) {
+  const auto separator = path.find_last_of("/\\");
+  return separator == std::string::npos ? path : path.substr(separator + 1);
+}
+
+SourceListing ListSource(const ScanSource& source) {
+  namespace fs = std::filesystem;
+  SourceListing listing;
+  std::error_code error_code;
+  fs::path canonical_directory;
+  if (source.kind == SourceKind::EXECUTABLES) {
+    canonical_directory = fs::canonical(source.directory, error_code);
+    if (error_code) {
+      return listing;
+    }
+  }
+  if (source.kind == SourceKind::SHORTCUTS) {
+    for (fs::recursive_directory_iterator
+             it(source.directory, fs::directory_options::skip_permission_denied,
+                error_code),
+         end;
+         !error_code && it != end; it.increment(error_code)) {
+      ListEntry(*it, source.kind, canonical_directory, &listing);
+    }
+  } else {
+    for (fs::directory_iterator it(source.directory, error_code), end;
+         !error_code && it != end; it.increment(error_code)) {
+      ListEntry(*it, source.kind, canonical_directory, &listing);
+    }
+  }
+
+  std::sort(listing.desktop_files.begin(), listing.desktop_files.end());
+  std::sort(listing.applications.begin(), listing.applications.end(),
+            [](const AppInfo& left, const AppInfo& right) {
+              return left.executable < right.executable;
+            });
+  std::sort(listing.executables.begin(), listing.executables.end(),
+            [](const PathExecutable& left, const PathExecutable& right) {
+              return left.info.name < right.info.name;
+            });
+  return listing;
+}
 
-  for (const auto& dir : app_dirs) {
-    if (!std::filesystem::exists(dir)) {
+std::string GetCommand(const std::string& command_line) {
+  for (const auto& token : ProcessLauncher::SplitArguments(command_line)) {
+    if (token != "env" && token.find('=') == std::string::npos) {
+      return token;
+    }
+  }
+  return {};
+}
+
+void MergePathExecutables(std::vector<AppInfo>* applications,
+                          std::vector<PathExecutable> executables) {
+  std::unordered_set<std::string> names;
+  std::unordered_set<std::string> application_paths;
+  names.reserve(applications->size() + executables.size());
+  for (const auto& app : *applications) {
+    const std::string command = GetCommand(app.executable);
+    if (command.empty()) {
       continue;
     }
+    names.insert(GetBaseName(command));
+    if (command.find('/') != std::string::npos) {
+      std::error_code error_code;
+      const auto canonical_path =
+          std::filesystem::canonical(command, error_code);
+      if (!error_code) {
+        application_paths.insert(canonical_path.string());
+      }
+    }
+  }
 
-    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
-      if (entry.path().extension() == ".desktop") {
-        AppInfo info = ParseDesktopFile(entry.path().string());
-        if (!info.name.empty() && !info.executable.empty()) {
-          applications_.push_back(info);
-        }
+  for (auto& executable : executables) {
+    if (application_paths.count(executable.canonical_path) == 0 &&
+        names.insert(executable.info.name).second) {
+      applications->push_back(std::move(executable.info));
+    }
+  }
+}
+
+class ProgressReporter {
+ public:
+  explicit ProgressReporter(const ScanOptions& options) : options_(options) {}
+
+  void AddTotal(size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    progress_.total += count;
+  }
+
+  void Complete(size_t found) {
+    if (!options_.on_progress) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++progress_.completed;
+    progress_.found += found;
+    if (progress_.completed % k_progress_interval == 0 ||
+        progress_.completed == progress_.total) {
+      options_.on_progress(progress_);
+    }
+  }
+
+ private:
+  const ScanOptions& options_;
+  std::mutex mutex_;
+  ScanProgress progress_;
+};
+}  // namespace
+
+struct AppDiscovery::ScanState {
+  std::unordered_map<std::string, CachedSource> sources;
+  std::unordered_map<std::string, CachedDesktopFile> desktop_files;
+};
+
+AppDiscovery::AppDiscovery() = default;
+
+AppDiscovery::~AppDiscovery() = default;
+
+size_t AppDiscovery::ScanSystem() { return ScanSystem(ScanOptions()); }
+
+size_t AppDiscovery::ScanSystem(const ScanOptions& options) {
+  const size_t jobs = options.max_workers;
+  auto is_cancelled = [&options]() {
+    return options.cancelled && options.cancelled->load();
+  };
+  ProgressReporter progress(options);
+  if (!scan_state_) {
+    scan_state_ = std::make_unique<ScanState>();
+  }
+  const ScanState& previous = *scan_state_;
+
+  const std::vector<ScanSource> sources = GetScanSources();
+  progress.AddTotal(sources.size());
+  std::vector<CachedSource> listed(sources.size());
+  ParallelFor(sources.size(), jobs, [&](size_t index) {
+    if (is_cancelled()) {
+      return;
+    }
+    CachedSource& source = listed[index];
+    const std::string& directory = sources[index].directory;
+    const bool stamped = AppCache::ReadStamp(directory, &source.stamp);
+    auto cached = previous.sources.find(directory);
+    if (stamped && sources[index].kind != SourceKind::SHORTCUTS &&
+        cached != previous.sources.end() &&
+        cached->second.stamp == source.stamp) {
+      source.listing = cached->second.listing;
+    } else {
+      source.listing = std::make_shared<const SourceListing>(
+          stamped ? ListSource(sources[index]) : SourceListing());
+    }
+    progress.Complete(source.listing->applications.size() +
+                      source.listing->executables.size());
+  });
+  if (is_cancelled()) {
+    return GetApplicationCount();
+  }
+
+  std::vector<std::string> desktop_files;
+  for (const auto& source : listed) {
+    desktop_files.insert(desktop_files.end(),
+                         source.listing->desktop_files.begin(),
+                         source.listing->desktop_files.end());
+  }
+  progress.AddTotal(desktop_files.size());
+  std::vector<CachedDesktopFile> parsed(desktop_files.size());
+  ParallelFor(desktop_files.size(), jobs, [&](size_t index) {
+    if (is_cancelled()) {
+      return;
+    }
+    CachedDesktopFile& file = parsed[index];
+    const std::string& path = desktop_files[index];
+    const bool stamped = AppCache::ReadStamp(path, &file.stamp);
+    auto cached = previous.desktop_files.find(path);
+    if (stamped && cached != previous.desktop_files.end() &&
+        cached->second.stamp == file.stamp) {
+      file.info = cached->second.info;
+    } else if (stamped) {
+      file.info = ParseDesktopFile(path);
+    }
+    const bool valid = !file.info.name.empty() && !file.info.executable.empty();
+    progress.Complete(valid ? 1 : 0);
+  });
+
+  if (is_cancelled()) {
+    return GetApplicationCount();
+  }
+
+  // A desktop file ID found in an earlier source shadows the same ID in the
+  // later ones, so user overrides replace the system entries.
+  std::vector<AppInfo> applications;
+  std::vector<PathExecutable> executables;
+  std::unordered_set<std::string> desktop_ids;
+  for (size_t i = 0, next_parsed = 0; i < sources.size(); ++i) {
+    const SourceListing& listing = *listed[i].listing;
+    for (size_t j = 0; j < listing.desktop_files.size(); ++j) {
+      const AppInfo& info = parsed[next_parsed++].info;
+      if (!desktop_ids.insert(GetBaseName(listing.desktop_files[j])).second) {
+        continue;
+      }
+      if (!info.name.empty() && !info.executable.empty()) {
+        applications.push_back(info);
       }
     }
+    applications.insert(applications.end(), listing.applications.begin(),
+                        listing.applications.end());
+    executables.insert(executables.end(), listing.executables.begin(),
+                       listing.executables.end());
+  }
+  MergePathExecutables(&applications, std::move(executables));
+
+  auto state = std::make_unique<ScanState>();
+  for (size_t i = 0; i < sources.size(); ++i) {
+    state->sources[sources[i].directory] = std::move(listed[i]);
   }
+  for (size_t i = 0; i < desktop_files.size(); ++i) {
+    state->desktop_files[desktop_files[i]] = std::move(parsed[i]);
+  }
+  scan_state_ = std::move(state);
+
+  applications_ = std::move(applications);
+  cache_.reset();
+  search_index_.reset();
+  return applications_.size();
 }
 
 AppInfo AppDiscovery::ParseDesktopFile(const std::string& filepath) {
@@ -155,151 +518,53 @@ AppInfo AppDiscovery::ParseDesktopFile(const std::string& filepath) {
   return info;
 }
 
-void AppDiscovery::ScanWindowsApplications() {
-#ifdef _WIN32
-  std::vector<std::string> menu_dirs;
-
-  CHAR path[MAX_PATH];
-  if (SUCCEEDED(SHGetFolderPathA(NULL, CSIDL_COMMON_PROGRAMS, NULL, 0, path))) {
-    menu_dirs.push_back(path);
-  }
-  if (SUCCEEDED(SHGetFolderPathA(NULL, CSIDL_PROGRAMS, NULL, 0, path))) {
-    menu_dirs.push_back(path);
-  }
-
-  for (const auto& dir : menu_dirs) {
-    if (!std::filesystem::exists(dir)) {
-      continue;
-    }
-
-    for (const auto& entry :
-         std::filesystem::recursive_directory_iterator(dir)) {
-      if (entry.path().extension() == ".lnk") {
-        AppInfo info;
-        info.name = entry.path().stem().string();
-        info.executable = entry.path().string();
-        info.category = "Application";
-        applications_.push_back(info);
-      }
+const std::vector<AppInfo>& AppDiscovery::GetApplications() const {
+  if (cache_) {
+    applications_.reserve(cache_->GetSize());
+    for (size_t i = 0; i < cache_->GetSize(); ++i) {
+      applications_.push_back(cache_->GetEntry(i).ToAppInfo());
     }
+    cache_.reset();
   }
-#endif
+  return applications_;
 }
 
-void AppDiscovery::ScanMacOSApplications() {
-#ifdef __APPLE__
-  std::vector<std::string> app_dirs = {
-      "/Applications",
-      std::string(getenv("HOME") ? getenv("HOME") : "") + "/Applications"};
-
-  for (const auto& dir : app_dirs) {
-    if (!std::filesystem::exists(dir)) {
-      continue;
-    }
-
-    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
-      if (entry.path().extension() == ".app") {
-        AppInfo info;
-        info.name = entry.path().stem().string();
-        info.executable = entry.path().string();
-        info.category = "Application";
-        applications_.push_back(info);
-      }
-    }
-  }
-#endif
+size_t AppDiscovery::GetApplicationCount() const {
+  return cache_ ? cache_->GetSize() : applications_.size();
 }
 
-void AppDiscovery::ScanPathEnvironment() {
-  const char* path_environment = std::getenv("PATH");
-  if (!path_environment) {
-    return;
-  }
-
-  std::string path_string(path_environment);
-  std::istringstream iss(path_string);
-  std::string dir;
-
-#ifdef _WIN32
-  char delimiter = ';';
-#else
-  char delimiter = ':';
-#endif
-
-  while (std::getline(iss, dir, delimiter)) {
-    if (!std::filesystem::exists(dir)) {
-      continue;
-    }
-
-    try {
-      for (const auto& entry : std::filesystem::directory_iterator(dir)) {
-        if (!entry.is_regular_file()) {
-          continue;
-        }
-
-        auto perms = entry.status().permissions();
-        bool is_executable = (perms & std::filesystem::perms::owner_exec) !=
-                             std::filesystem::perms::none;
-
-        if (is_executable) {
-          std::string filename = entry.path().filename().string();
-
-          bool already_exists = false;
-          for (const auto& app : applications_) {
-            if (app.executable.find(filename) != std::string::npos) {
-              already_exists = true;
-              break;
-            }
-          }
-
-          if (!already_exists) {
-            AppInfo info;
-            info.name = filename;
-            info.executable = entry.path().string();
-            info.category = "Command-Line";
-            applications_.push_back(info);
-          }
-        }
-      }
-    } catch (...) {
-    }
-  }
+std::string_view AppDiscovery::GetApplicationName(size_t index) const {
+  return cache_ ? cache_->GetEntry(index).GetName()
+                : std::string_view(applications_[index].name);
 }
 
-const std::vector<AppInfo>& AppDiscovery::GetApplications() const {
-  return applications_;
+std::string_view AppDiscovery::GetApplicationCategory(size_t index) const {
+  return cache_ ? cache_->GetEntry(index).GetCategory()
+                : std::string_view(applications_[index].category);
 }
 
-std::vector<AppInfo> AppDiscovery::SearchApplications(
-    const std::string& query) const {
-  std::vector<AppInfo> results;
-
-  if (query.empty()) {
-    return applications_;
-  }
-
-  std::string lower_query = query;
-  std::transform(lower_query.begin(), lower_query.end(), lower_query.begin(),
-                 ::tolower);
-
-  for (const auto& app : applications_) {
-    std::string lower_name = app.name;
-    std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(),
-                   ::tolower);
+AppInfo AppDiscovery::GetApplication(size_t index) const {
+  return cache_ ? cache_->GetEntry(index).ToAppInfo() : applications_[index];
+}
 
-    if (lower_name.find(lower_query) != std::string::npos) {
-      results.push_back(app);
+std::vector<size_t> AppDiscovery::SearchApplications(const std::string& query,
+                                                     size_t limit) const {
+  if (!search_index_) {
+    search_index_ = std::make_unique<AppSearchIndex>();
+    if (cache_) {
+      search_index_->Build(*cache_);
+    } else {
+      search_index_->Build(applications_);
     }
   }
-
-  return results;
+  return search_index_->Search(query, limit);
 }
 
 std::vector<AppInfo> AppDiscovery::GetApplicationsByCategory(
     const std::string& category) const {
   std::vector<AppInfo> results;
 
-  for (const auto& app : applications_) {
+  for (const auto& app : GetApplications()) {
     if (app.category == category) {
       results.push_back(app);
     }
@@ -311,11 +576,12 @@ std::vector<AppInfo> AppDiscovery::GetApplicationsByCategory(
 std::vector<std::string> AppDiscovery::GetCategories() const {
   std::vector<std::string> categories;
 
-  for (const auto& app : applications_) {
-    if (!app.category.empty()) {
-      auto it = std::find(categories.begin(), categories.end(), app.category);
+  for (size_t i = 0; i < GetApplicationCount(); ++i) {
+    const std::string_view category = GetApplicationCategory(i);
+    if (!category.empty()) {
+      auto it = std::find(categories.begin(), categories.end(), category);
       if (it == categories.end()) {
-        categories.push_back(app.category);
+        categories.emplace_back(category);
       }
     }
   }
@@ -324,80 +590,58 @@ std::vector<std::string> AppDiscovery::GetCategories() const {
   return categories;
 }
 
-void AppDiscovery::clear() { applications_.clear(); }
-
-bool AppDiscovery::SaveCache(const std::string& filepath) const {
-  std::ofstream file(filepath);
-  if (!file.is_open()) {
-    return false;
-  }
-
-  for (const auto& app : applications_) {
-    file << "NAME:" << app.name << "\n";
-    file << "EXEC:" << app.executable << "\n";
-    file << "DESC:" << app.description << "\n";
-    file << "ICON:" << app.icon_path << "\n";
-    file << "CATEGORY:" << app.category << "\n";
-    file << "---\n";
+std::vector<std::string> AppDiscovery::GetWatchDirectories() {
+  std::vector<std::string> directories;
+  for (const auto& source : GetScanSources()) {
+    directories.push_back(source.directory);
   }
-
-  return true;
+  return directories;
 }
 
-bool AppDiscovery::LoadCache(const std::string& filepath) {
-  std::ifstream file(filepath);
-  if (!file.is_open()) {
-    return false;
-  }
-
-  clear();
-
-  AppInfo current_app;
-  std::string line;
+void AppDiscovery::SetApplications(std::vector<AppInfo> applications) {
+  applications_ = std::move(applications);
+  cache_.reset();
+  search_index_.reset();
+}
 
-  while (std::getline(file, line)) {
-    if (line == "---") {
-      if (!current_app.name.empty()) {
-        applications_.push_back(current_app);
-        current_app = AppInfo();
-      }
-      continue;
-    }
+void AppDiscovery::clear() {
+  applications_.clear();
+  cache_.reset();
+  scan_state_.reset();
+  search_index_.reset();
+}
 
-    size_t pos = line.find(':');
-    if (pos == std::string::npos) {
-      continue;
+bool AppDiscovery::SaveCache(const std::string& filepath) const {
+  std::vector<SourceFingerprint> sources;
+  for (auto& directory : GetWatchDirectories()) {
+    SourceFingerprint source{std::move(directory), FileStamp()};
+    const CachedSource* cached = nullptr;
+    if (scan_state_) {
+      auto it = scan_state_->sources.find(source.directory);
+      cached = it != scan_state_->sources.end() ? &it->second : nullptr;
     }
-
-    std::string key = line.substr(0, pos);
-    std::string value = line.substr(pos + 1);
-
-    if (key == "NAME") {
-      current_app.name = value;
+    if (cached) {
+      source.stamp = cached->stamp;
     } else {
-      if (key == "EXEC") {
-        current_app.executable = value;
-      } else {
-        if (key == "DESC") {
-          current_app.description = value;
-        } else {
-          if (key == "ICON") {
-            current_app.icon_path = value;
-          } else {
-            if (key == "CATEGORY") {
-              current_app.category = value;
-            }
-          }
-        }
-      }
+      AppCache::ReadStamp(source.directory, &source.stamp);
     }
+    sources.push_back(std::move(source));
   }
+  return AppCache::Write(filepath, GetApplications(), sources);
+}
 
-  if (!current_app.name.empty()) {
-    applications_.push_back(current_app);
+bool AppDiscovery::LoadCache(const std::string& filepath, bool* is_fresh) {
+  auto cache = std::make_unique<AppCache>();
+  if (!cache->Open(filepath)) {
+    return false;
   }
 
+  clear();
+  if (is_fresh) {
+    *is_fresh = cache->IsFresh(GetWatchDirectories());
+  }
+  cache_ = std::move(cache);
   return true;
 }
 
-}  // namespace BreadBin
\ No newline at end of file
+}  // namespace BreadBin
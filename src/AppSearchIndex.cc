@@ -0,0 +1,282 @@
+#include "AppSearchIndex.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "AppCache.h"
+
+namespace BreadBin {
+namespace {
+constexpr size_t k_trigram_size = 3;
+constexpr int k_exact_score = 1000;
+constexpr int k_prefix_score = 800;
+constexpr int k_word_prefix_score = 600;
+constexpr int k_substring_score = 400;
+constexpr int k_executable_prefix_score = 350;
+constexpr int k_fuzzy_score = 300;
+constexpr int k_executable_substring_score = 200;
+constexpr int k_category_score = 120;
+constexpr int k_description_score = 80;
+constexpr int k_length_bonus = 50;
+constexpr int k_max_score = k_exact_score + k_length_bonus;
+
+std::string Fold(std::string_view text) {
+  std::string folded(text);
+  for (char& c : folded) {
+    if (c >= 'A' && c <= 'Z') {
+      c = static_cast<char>(c - 'A' + 'a');
+    }
+  }
+  return folded;
+}
+
+std::string_view Trim(std::string_view text) {
+  const auto first = text.find_first_not_of(" \t");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  const auto last = text.find_last_not_of(" \t");
+  return text.substr(first, last - first + 1);
+}
+
+uint32_t MakeTrigram(const char* text) {
+  return static_cast<uint32_t>(static_cast<unsigned char>(text[0])) << 16 |
+         static_cast<uint32_t>(static_cast<unsigned char>(text[1])) << 8 |
+         static_cast<uint32_t>(static_cast<unsigned char>(text[2]));
+}
+
+uint64_t MakeMask(std::string_view text) {
+  uint64_t mask = 0;
+  for (char c : text) {
+    if (c >= 'a' && c <= 'z') {
+      mask |= uint64_t{1} << (c - 'a');
+    } else if (c >= '0' && c <= '9') {
+      mask |= uint64_t{1} << (26 + c - '0');
+    } else {
+      mask |= uint64_t{1} << (36 + static_cast<unsigned char>(c) % 28);
+    }
+  }
+  return mask;
+}
+
+bool ContainsMask(uint64_t mask, uint64_t query_mask) {
+  return (mask & query_mask) == query_mask;
+}
+
+bool IsWordBoundary(char c) {
+  return c == ' ' || c == '-' || c == '_' || c == '.' || c == '/';
+}
+
+std::string_view GetBaseName(std::string_view path) {
+  const auto separator = path.find_last_of('/');
+  return separator == std::string_view::npos ? path
+                                             : path.substr(separator + 1);
+}
+
+int ScoreFuzzy(std::string_view text, std::string_view query) {
+  size_t position = 0;
+  int gaps = 0;
+  for (char c : query) {
+    const auto found = text.find(c, position);
+    if (found == std::string_view::npos) {
+      return 0;
+    }
+    if (found != position && position != 0) {
+      ++gaps;
+    }
+    position = found + 1;
+  }
+  return std::max(1, k_fuzzy_score - 20 * gaps -
+                         static_cast<int>(text.size() - query.size()));
+}
+}  // namespace
+
+void AppSearchIndex::Build(const std::vector<AppInfo>& applications) {
+  Clear();
+  documents_.reserve(applications.size());
+  for (const auto& app : applications) {
+    AddDocument(app.name, app.executable, app.category, app.description);
+  }
+  SortByName();
+}
+
+void AppSearchIndex::Build(const AppCache& cache) {
+  Clear();
+  documents_.reserve(cache.GetSize());
+  for (size_t i = 0; i < cache.GetSize(); ++i) {
+    const AppCache::Entry entry = cache.GetEntry(i);
+    AddDocument(entry.GetName(), entry.GetExecutable(), entry.GetCategory(),
+                entry.GetDescription());
+  }
+  SortByName();
+}
+
+void AppSearchIndex::AddDocument(std::string_view name,
+                                 std::string_view executable,
+                                 std::string_view category,
+                                 std::string_view description) {
+  const auto id = static_cast<uint32_t>(documents_.size());
+  Document& document = documents_.emplace_back();
+  document.name = Fold(name);
+  document.executable = Fold(executable);
+  document.category = Fold(category);
+  document.description = Fold(description);
+  document.command = GetBaseName(document.executable);
+  document.name_mask = MakeMask(document.name);
+  document.command_mask = MakeMask(document.command);
+  for (const std::string* field :
+       {&document.executable, &document.category, &document.description}) {
+    for (size_t i = 0; i + k_trigram_size <= field->size(); ++i) {
+      auto& postings = trigrams_[MakeTrigram(field->data() + i)];
+      if (postings.empty() || postings.back() != id) {
+        postings.push_back(id);
+      }
+    }
+  }
+}
+
+void AppSearchIndex::SortByName() {
+  name_order_.resize(documents_.size());
+  std::iota(name_order_.begin(), name_order_.end(), 0);
+  std::stable_sort(name_order_.begin(), name_order_.end(),
+                   [this](uint32_t left, uint32_t right) {
+                     return documents_[left].name < documents_[right].name;
+                   });
+}
+
+void AppSearchIndex::Clear() {
+  documents_.clear();
+  name_order_.clear();
+  trigrams_.clear();
+}
+
+size_t AppSearchIndex::GetSize() const { return documents_.size(); }
+
+std::vector<uint32_t> AppSearchIndex::FindTrigramCandidates(
+    std::string_view query) const {
+  std::vector<const std::vector<uint32_t>*> lists;
+  for (size_t i = 0; i + k_trigram_size <= query.size(); ++i) {
+    auto it = trigrams_.find(MakeTrigram(query.data() + i));
+    if (it == trigrams_.end()) {
+      return {};
+    }
+    lists.push_back(&it->second);
+  }
+  std::sort(lists.begin(), lists.end(),
+            [](const auto* left, const auto* right) {
+              return left->size() < right->size();
+            });
+
+  std::vector<uint32_t> candidates = *lists.front();
+  std::vector<uint32_t> intersection;
+  for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+    intersection.clear();
+    std::set_intersection(candidates.begin(), candidates.end(),
+                          lists[i]->begin(), lists[i]->end(),
+                          std::back_inserter(intersection));
+    candidates.swap(intersection);
+  }
+  return candidates;
+}
+
+int AppSearchIndex::Score(const Document& document, std::string_view query,
+                          uint64_t query_mask, bool use_details) {
+  const std::string_view name = document.name;
+  if (ContainsMask(document.name_mask, query_mask)) {
+    int score = 0;
+    if (name == query) {
+      score = k_exact_score;
+    } else if (name.compare(0, query.size(), query) == 0) {
+      score = k_prefix_score;
+    } else if (const auto found = name.find(query);
+               found != std::string_view::npos) {
+      score = IsWordBoundary(name[found - 1]) ? k_word_prefix_score
+                                              : k_substring_score;
+    }
+    if (score > 0) {
+      return score +
+             std::max(0, k_length_bonus - static_cast<int>(name.size()));
+    }
+  }
+
+  if (document.command.compare(0, query.size(), query) == 0) {
+    return k_executable_prefix_score;
+  }
+  if (ContainsMask(document.name_mask, query_mask)) {
+    if (const int score = ScoreFuzzy(name, query); score > 0) {
+      return score;
+    }
+  }
+  if (!use_details) {
+    return 0;
+  }
+  if (document.executable.find(query) != std::string::npos) {
+    return k_executable_substring_score;
+  }
+  if (document.category.find(query) != std::string::npos) {
+    return k_category_score;
+  }
+  if (document.description.find(query) != std::string::npos) {
+    return k_description_score;
+  }
+  return 0;
+}
+
+std::vector<size_t> AppSearchIndex::Search(std::string_view query,
+                                           size_t limit) const {
+  const std::string folded = Fold(Trim(query));
+  if (folded.empty()) {
+    std::vector<size_t> all(documents_.size());
+    std::iota(all.begin(), all.end(), 0);
+    if (limit > 0 && all.size() > limit) {
+      all.resize(limit);
+    }
+    return all;
+  }
+
+  std::vector<uint32_t> details;
+  std::vector<bool> has_details;
+  if (folded.size() >= k_trigram_size) {
+    details = FindTrigramCandidates(folded);
+    has_details.resize(documents_.size());
+    for (uint32_t id : details) {
+      has_details[id] = true;
+    }
+  }
+
+  const uint64_t query_mask = MakeMask(folded);
+  std::vector<std::pair<int, uint32_t>> matches;
+  for (uint32_t id : name_order_) {
+    const Document& document = documents_[id];
+    const bool use_details = !has_details.empty() && has_details[id];
+    if (!use_details && !ContainsMask(document.name_mask, query_mask) &&
+        !ContainsMask(document.command_mask, query_mask)) {
+      continue;
+    }
+    if (const int score = Score(document, folded, query_mask, use_details);
+        score > 0) {
+      matches.emplace_back(score, id);
+    }
+  }
+
+  std::vector<size_t> positions(k_max_score + 1);
+  for (const auto& match : matches) {
+    ++positions[match.first];
+  }
+  size_t position = 0;
+  for (int score = k_max_score; score > 0; --score) {
+    const size_t count = positions[score];
+    positions[score] = position;
+    position += count;
+  }
+  std::vector<size_t> results(matches.size());
+  for (const auto& match : matches) {
+    results[positions[match.first]++] = match.second;
+  }
+  if (limit > 0 && results.size() > limit) {
+    results.resize(limit);
+  }
+  return results;
+}
+
+}  // namespace BreadBin
@@ -0,0 +1,175 @@
+#include "AppWatcher.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <utility>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace BreadBin {
+namespace {
+constexpr size_t k_event_buffer_size = 16 * 1024;
+
+#ifdef __linux__
+constexpr uint32_t k_directory_mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                                      IN_MOVED_TO | IN_CLOSE_WRITE |
+                                      IN_DELETE_SELF | IN_MOVE_SELF |
+                                      IN_ONLYDIR;
+// A missing directory is waited for on its nearest existing ancestor, which
+// only needs to report entries appearing. IN_MASK_ADD keeps the full mask
+// if that ancestor is itself a watched directory.
+constexpr uint32_t k_ancestor_mask =
+    IN_CREATE | IN_MOVED_TO | IN_ONLYDIR | IN_MASK_ADD;
+#endif
+}  // namespace
+
+AppWatcher::AppWatcher(Callback callback,
+                       std::chrono::milliseconds settle_delay)
+    : callback_(std::move(callback)),
+      settle_delay_(settle_delay),
+      inotify_descriptor_(-1),
+      wake_descriptor_(-1) {}
+
+AppWatcher::~AppWatcher() { Stop(); }
+
+bool AppWatcher::IsActive() const { return thread_.joinable(); }
+
+#ifdef __linux__
+bool AppWatcher::IsSupported() { return true; }
+
+bool AppWatcher::Start(const std::vector<std::string>& directories) {
+  if (IsActive()) {
+    return true;
+  }
+
+  inotify_descriptor_ = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+  wake_descriptor_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (inotify_descriptor_ < 0 || wake_descriptor_ < 0) {
+    Stop();
+    return false;
+  }
+
+  directories_ = directories;
+  directory_watches_.clear();
+  if (directories_.empty()) {
+    Stop();
+    return false;
+  }
+  Rearm();
+
+  thread_ = std::thread(&AppWatcher::Loop, this);
+  return true;
+}
+
+bool AppWatcher::Rearm() {
+  bool added = false;
+  for (const auto& directory : directories_) {
+    const int watch = inotify_add_watch(inotify_descriptor_,
+                                        directory.c_str(), k_directory_mask);
+    if (watch >= 0) {
+      added = directory_watches_.insert(watch).second || added;
+      continue;
+    }
+
+    std::string ancestor = directory;
+    while (true) {
+      const size_t slash = ancestor.find_last_of('/');
+      if (slash == std::string::npos) {
+        break;
+      }
+      ancestor.resize(slash == 0 ? 1 : slash);
+      if (inotify_add_watch(inotify_descriptor_, ancestor.c_str(),
+                            k_ancestor_mask) >= 0 ||
+          slash == 0) {
+        break;
+      }
+    }
+  }
+  return added;
+}
+
+void AppWatcher::Stop() {
+  if (thread_.joinable()) {
+    const uint64_t value = 1;
+    [[maybe_unused]] const ssize_t written =
+        write(wake_descriptor_, &value, sizeof(value));
+    thread_.join();
+  }
+  if (inotify_descriptor_ >= 0) {
+    close(inotify_descriptor_);
+    inotify_descriptor_ = -1;
+  }
+  if (wake_descriptor_ >= 0) {
+    close(wake_descriptor_);
+    wake_descriptor_ = -1;
+  }
+}
+
+void AppWatcher::Loop() {
+  alignas(inotify_event) char buffer[k_event_buffer_size];
+  bool pending = false;
+  while (true) {
+    pollfd descriptors[2] = {{wake_descriptor_, POLLIN, 0},
+                             {inotify_descriptor_, POLLIN, 0}};
+    const int timeout =
+        pending ? static_cast<int>(settle_delay_.count()) : -1;
+    const int count = poll(descriptors, 2, timeout);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    if (descriptors[0].revents != 0) {
+      return;
+    }
+    if (count == 0) {
+      pending = false;
+      if (callback_) {
+        callback_();
+      }
+      continue;
+    }
+
+    // Events on a watched directory change its contents. Anything else comes
+    // from an ancestor, and only matters once a missing directory appears.
+    bool rearm = false;
+    ssize_t length = 0;
+    while ((length = read(inotify_descriptor_, buffer, sizeof(buffer))) > 0) {
+      for (char* next = buffer; next < buffer + length;) {
+        const auto* event = reinterpret_cast<const inotify_event*>(next);
+        next += sizeof(inotify_event) + event->len;
+        if (event->wd < 0 || directory_watches_.count(event->wd) != 0) {
+          pending = true;
+          if ((event->mask & IN_IGNORED) != 0) {
+            directory_watches_.erase(event->wd);
+            rearm = true;
+          }
+        } else {
+          rearm = true;
+        }
+      }
+    }
+    if (rearm && Rearm()) {
+      pending = true;
+    }
+  }
+}
+#else
+bool AppWatcher::IsSupported() { return false; }
+
+bool AppWatcher::Start(const std::vector<std::string>& directories) {
+  return false;
+}
+
+void AppWatcher::Stop() {}
+
+void AppWatcher::Loop() {}
+#endif
+
+}  // namespace BreadBin
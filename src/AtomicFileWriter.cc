@@ -0,0 +1,202 @@
+#include "AtomicFileWriter.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BreadBin {
+namespace {
+std::atomic<SyncPolicy> g_default_sync_policy{SyncPolicy::FILE_AND_DIRECTORY};
+
+#ifndef _WIN32
+// New files are created like open(2) would, so the umask still applies.
+constexpr mode_t k_new_file_mode = 0666;
+constexpr int k_max_symlink_depth = 40;
+constexpr int k_max_temp_attempts = 100;
+std::atomic<unsigned> g_temp_counter{0};
+
+std::string DirectoryOf(const std::string& filepath) {
+  const auto slash = filepath.find_last_of('/');
+  if (slash == std::string::npos) {
+    return ".";
+  }
+  return slash == 0 ? "/" : filepath.substr(0, slash);
+}
+
+// Follows symlinks so the rename replaces the file they point to instead of
+// the link itself. The final target does not need to exist yet.
+std::string ResolveTarget(std::string filepath) {
+  for (int depth = 0; depth < k_max_symlink_depth; ++depth) {
+    struct stat status {};
+    if (lstat(filepath.c_str(), &status) != 0 || !S_ISLNK(status.st_mode)) {
+      break;
+    }
+    std::vector<char> target(static_cast<size_t>(status.st_size) + 1);
+    const ssize_t length =
+        readlink(filepath.c_str(), target.data(), target.size());
+    if (length < 0 || static_cast<size_t>(length) >= target.size()) {
+      break;
+    }
+    std::string link(target.data(), static_cast<size_t>(length));
+    filepath =
+        link.starts_with('/') ? link : DirectoryOf(filepath) + "/" + link;
+  }
+  return filepath;
+}
+
+int CreateTempFile(const std::string& filepath, std::string* temp_path) {
+  for (int attempt = 0; attempt < k_max_temp_attempts; ++attempt) {
+    *temp_path = filepath + ".tmp." + std::to_string(getpid()) + "." +
+                 std::to_string(g_temp_counter++);
+    const int descriptor =
+        open(temp_path->c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+             k_new_file_mode);
+    if (descriptor >= 0 || errno != EEXIST) {
+      return descriptor;
+    }
+  }
+  errno = EEXIST;
+  return -1;
+}
+
+bool WriteAll(int descriptor, std::string_view contents) {
+  while (!contents.empty()) {
+    const ssize_t written = write(descriptor, contents.data(), contents.size());
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    contents.remove_prefix(static_cast<size_t>(written));
+  }
+  return true;
+}
+
+bool SyncDirectory(const std::string& directory) {
+  const int descriptor = open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+  if (descriptor < 0) {
+    return false;
+  }
+  const bool synced = fsync(descriptor) == 0;
+  close(descriptor);
+  return synced;
+}
+#endif
+
+void SetError(std::string* error, const std::string& message) {
+  if (error) {
+    *error = message;
+  }
+}
+}  // namespace
+
+AtomicFileWriter::AtomicFileWriter(std::string filepath)
+    : AtomicFileWriter(std::move(filepath), GetDefaultSyncPolicy()) {}
+
+AtomicFileWriter::AtomicFileWriter(std::string filepath, SyncPolicy policy)
+    : filepath_(std::move(filepath)), policy_(policy) {}
+
+std::ostream& AtomicFileWriter::Stream() { return buffer_; }
+
+bool AtomicFileWriter::Commit() {
+  if (!buffer_) {
+    error_ = filepath_ + ": failed to format contents";
+    return false;
+  }
+  const std::string contents = std::move(buffer_).str();
+  return WriteFile(filepath_, contents, policy_, &error_);
+}
+
+const std::string& AtomicFileWriter::GetError() const { return error_; }
+
+void AtomicFileWriter::SetDefaultSyncPolicy(SyncPolicy policy) {
+  g_default_sync_policy = policy;
+}
+
+SyncPolicy AtomicFileWriter::GetDefaultSyncPolicy() {
+  return g_default_sync_policy;
+}
+
+#ifdef _WIN32
+bool AtomicFileWriter::WriteFile(const std::string& filepath,
+                                 std::string_view contents, SyncPolicy policy,
+                                 std::string* error) {
+  const std::string temp_path = filepath + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    file.flush();
+    if (!file.good()) {
+      std::remove(temp_path.c_str());
+      SetError(error, filepath + ": write failed");
+      return false;
+    }
+  }
+
+  std::remove(filepath.c_str());
+  if (std::rename(temp_path.c_str(), filepath.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    SetError(error, filepath + ": rename failed");
+    return false;
+  }
+  return true;
+}
+#else
+bool AtomicFileWriter::WriteFile(const std::string& filepath,
+                                 std::string_view contents, SyncPolicy policy,
+                                 std::string* error) {
+  const std::string target = ResolveTarget(filepath);
+  std::string temp_path;
+  const int descriptor = CreateTempFile(target, &temp_path);
+  if (descriptor < 0) {
+    SetError(error, filepath + ": " + std::strerror(errno));
+    return false;
+  }
+
+  // Replacing an existing file keeps its permissions.
+  struct stat existing {};
+  bool written = (stat(target.c_str(), &existing) != 0 ||
+                  fchmod(descriptor, existing.st_mode & 07777) == 0) &&
+                 WriteAll(descriptor, contents);
+  if (written && policy != SyncPolicy::NONE) {
+    written = fsync(descriptor) == 0;
+  }
+  int saved_errno = written ? 0 : errno;
+  if (close(descriptor) != 0 && written) {
+    written = false;
+    saved_errno = errno;
+  }
+  if (!written) {
+    unlink(temp_path.c_str());
+    SetError(error, filepath + ": " + std::strerror(saved_errno));
+    return false;
+  }
+
+  if (rename(temp_path.c_str(), target.c_str()) != 0) {
+    SetError(error, filepath + ": " + std::strerror(errno));
+    unlink(temp_path.c_str());
+    return false;
+  }
+
+  if (policy == SyncPolicy::FILE_AND_DIRECTORY &&
+      !SyncDirectory(DirectoryOf(target))) {
+    SetError(error, DirectoryOf(target) + ": " + std::strerror(errno));
+    return false;
+  }
+  return true;
+}
+#endif
+
+}  // namespace BreadBin
@@ -0,0 +1,59 @@
+#include "ByteCodec.h"
+
+namespace BreadBin {
+namespace {
+constexpr size_t k_length_size = sizeof(uint32_t);
+}  // namespace
+
+void WriteInteger(std::string& buffer, uint64_t value, size_t bytes) {
+  for (size_t i = 0; i < bytes; ++i) {
+    buffer += static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+}
+
+void WriteString(std::string& buffer, std::string_view value) {
+  WriteInteger(buffer, value.size(), k_length_size);
+  buffer += value;
+}
+
+uint64_t ReadInteger(const char* data, size_t bytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < bytes; ++i) {
+    value |= static_cast<uint64_t>(static_cast<unsigned char>(data[i]))
+             << (8 * i);
+  }
+  return value;
+}
+
+ByteReader::ByteReader(std::string_view data) : data_(data), valid_(true) {}
+
+uint64_t ByteReader::ReadInteger(size_t bytes) {
+  if (!Require(bytes)) {
+    return 0;
+  }
+  const uint64_t value = BreadBin::ReadInteger(data_.data(), bytes);
+  data_.remove_prefix(bytes);
+  return value;
+}
+
+std::string ByteReader::ReadString() {
+  const auto length = static_cast<size_t>(ReadInteger(k_length_size));
+  if (!Require(length)) {
+    return {};
+  }
+  std::string value(data_.substr(0, length));
+  data_.remove_prefix(length);
+  return value;
+}
+
+bool ByteReader::IsValid() const { return valid_; }
+
+bool ByteReader::IsComplete() const { return valid_ && data_.empty(); }
+
+bool ByteReader::Require(size_t bytes) {
+  if (!valid_ || bytes > data_.size()) {
+    valid_ = false;
+  }
+  return valid_;
+}
+}  // namespace BreadBin
@@ -0,0 +1,226 @@
+#include "ControlProtocol.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "ByteCodec.h"
+
+namespace BreadBin {
+namespace {
+constexpr size_t k_length_size = sizeof(uint32_t);
+#ifdef MSG_NOSIGNAL
+constexpr int k_send_flags = MSG_NOSIGNAL;
+#else
+constexpr int k_send_flags = 0;
+#endif
+
+#ifndef _WIN32
+bool SendAll(int descriptor, std::string_view data) {
+  while (!data.empty()) {
+    const ssize_t sent =
+        send(descriptor, data.data(), data.size(), k_send_flags);
+    if (sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data.remove_prefix(static_cast<size_t>(sent));
+  }
+  return true;
+}
+#endif
+}  // namespace
+
+std::string ControlProtocol::EncodeRequest(const ControlRequest& request) {
+  std::string payload;
+  WriteInteger(payload, static_cast<uint8_t>(request.command), 1);
+  WriteString(payload, request.target);
+  return payload;
+}
+
+bool ControlProtocol::DecodeRequest(std::string_view payload,
+                                    ControlRequest* request) {
+  ByteReader reader(payload);
+  const auto command = static_cast<uint8_t>(reader.ReadInteger(1));
+  request->target = reader.ReadString();
+  if (command < static_cast<uint8_t>(ControlCommand::START) ||
+      command > static_cast<uint8_t>(ControlCommand::SHUTDOWN)) {
+    return false;
+  }
+  request->command = static_cast<ControlCommand>(command);
+  return reader.IsComplete();
+}
+
+std::string ControlProtocol::EncodeResponse(const ControlResponse& response) {
+  std::string payload;
+  WriteInteger(payload, response.ok ? 1 : 0, 1);
+  WriteString(payload, response.message);
+  WriteInteger(payload, response.loafs.size(), 4);
+  for (const auto& loaf : response.loafs) {
+    WriteString(payload, loaf.id);
+    WriteString(payload, loaf.name);
+    WriteString(payload, loaf.state);
+    WriteString(payload, loaf.error);
+    WriteInteger(payload, loaf.items.size(), 4);
+    for (const auto& item : loaf.items) {
+      WriteString(payload, item.id);
+      WriteInteger(payload, item.state, 1);
+      WriteInteger(payload, static_cast<uint32_t>(item.exit_code), 4);
+      WriteInteger(payload, item.restart_count, 4);
+      WriteInteger(payload, static_cast<uint64_t>(item.process_id), 8);
+    }
+  }
+  return payload;
+}
+
+bool ControlProtocol::DecodeResponse(std::string_view payload,
+                                     ControlResponse* response) {
+  ByteReader reader(payload);
+  response->ok = reader.ReadInteger(1) != 0;
+  response->message = reader.ReadString();
+  response->loafs.clear();
+  const auto loaf_count = reader.ReadInteger(4);
+  for (uint64_t i = 0; i < loaf_count && reader.IsValid(); ++i) {
+    LoafStatus loaf;
+    loaf.id = reader.ReadString();
+    loaf.name = reader.ReadString();
+    loaf.state = reader.ReadString();
+    loaf.error = reader.ReadString();
+    const auto item_count = reader.ReadInteger(4);
+    for (uint64_t j = 0; j < item_count && reader.IsValid(); ++j) {
+      ItemStatus item;
+      item.id = reader.ReadString();
+      item.state = static_cast<uint8_t>(reader.ReadInteger(1));
+      item.exit_code = static_cast<int32_t>(reader.ReadInteger(4));
+      item.restart_count = static_cast<uint32_t>(reader.ReadInteger(4));
+      item.process_id = static_cast<int64_t>(reader.ReadInteger(8));
+      loaf.items.push_back(std::move(item));
+    }
+    response->loafs.push_back(std::move(loaf));
+  }
+  return reader.IsComplete();
+}
+
+std::string ControlProtocol::Frame(std::string_view payload) {
+  std::string frame;
+  frame.reserve(k_length_size + payload.size());
+  WriteInteger(frame, payload.size(), k_length_size);
+  frame += payload;
+  return frame;
+}
+
+bool ControlProtocol::TakeFrame(std::string* buffer, std::string* payload,
+                                bool* malformed) {
+  *malformed = false;
+  if (buffer->size() < k_length_size) {
+    return false;
+  }
+  ByteReader reader(std::string_view(*buffer).substr(0, k_length_size));
+  const auto length = static_cast<size_t>(reader.ReadInteger(k_length_size));
+  if (length > k_max_frame_size) {
+    *malformed = true;
+    return false;
+  }
+  if (buffer->size() < k_length_size + length) {
+    return false;
+  }
+  payload->assign(*buffer, k_length_size, length);
+  buffer->erase(0, k_length_size + length);
+  return true;
+}
+
+std::string ControlProtocol::DefaultSocketPath() {
+  const char* runtime_directory = std::getenv("XDG_RUNTIME_DIR");
+  if (runtime_directory && *runtime_directory) {
+    return std::string(runtime_directory) + "/breadbind.sock";
+  }
+#ifdef _WIN32
+  return "breadbind.sock";
+#else
+  return "/tmp/breadbind-" + std::to_string(getuid()) + ".sock";
+#endif
+}
+
+#ifdef _WIN32
+bool ControlProtocol::Call(const std::string& socket_path,
+                           const ControlRequest& request,
+                           ControlResponse* response, std::string* error) {
+  if (error) {
+    *error = "Unix domain sockets are not supported on this platform";
+  }
+  return false;
+}
+#else
+bool ControlProtocol::Call(const std::string& socket_path,
+                           const ControlRequest& request,
+                           ControlResponse* response, std::string* error) {
+  auto fail = [error](const std::string& message) {
+    if (error) {
+      *error = message;
+    }
+    return false;
+  };
+
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(address.sun_path)) {
+    return fail(socket_path + ": socket path too long");
+  }
+  std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+  const int descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (descriptor < 0) {
+    return fail(std::strerror(errno));
+  }
+  fcntl(descriptor, F_SETFD, FD_CLOEXEC);
+  if (connect(descriptor, reinterpret_cast<const sockaddr*>(&address),
+              sizeof(address)) != 0) {
+    const int connect_error = errno;
+    close(descriptor);
+    return fail(socket_path + ": " + std::strerror(connect_error));
+  }
+
+  if (!SendAll(descriptor, Frame(EncodeRequest(request)))) {
+    const int send_error = errno;
+    close(descriptor);
+    return fail(std::strerror(send_error));
+  }
+
+  std::string buffer;
+  std::string payload;
+  bool malformed = false;
+  char chunk[4096];
+  while (!TakeFrame(&buffer, &payload, &malformed)) {
+    if (malformed) {
+      close(descriptor);
+      return fail("Malformed response from daemon");
+    }
+    const ssize_t received = recv(descriptor, chunk, sizeof(chunk), 0);
+    if (received < 0 && errno == EINTR) {
+      continue;
+    }
+    if (received <= 0) {
+      close(descriptor);
+      return fail("Connection closed by daemon");
+    }
+    buffer.append(chunk, static_cast<size_t>(received));
+  }
+  close(descriptor);
+
+  if (!DecodeResponse(payload, response)) {
+    return fail("Malformed response from daemon");
+  }
+  return true;
+}
+#endif
+
+}  // namespace BreadBin
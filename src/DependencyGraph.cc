@@ -0,0 +1,239 @@
+#include "DependencyGraph.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace BreadBin {
+DependencyGraph::DependencyGraph() = default;
+
+DependencyGraph::DependencyGraph(
+    const std::vector<std::shared_ptr<LoafItem>>& items) {
+  for (const auto& item : items) {
+    if (!item) {
+      continue;
+    }
+    index_by_id_.emplace(item->GetId(), nodes_.size());
+    nodes_.push_back(Node{item, item->GetDependencyRevision(), {}, {}});
+  }
+
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    auto& node = nodes_[i];
+    for (const auto& dependency : node.item->GetDependencies()) {
+      auto it = index_by_id_.find(dependency);
+      if (it == index_by_id_.end()) {
+        warnings_.push_back(node.item->GetId() + " depends on unknown item " +
+                            dependency);
+        continue;
+      }
+      if (it->second == i) {
+        warnings_.push_back(node.item->GetId() + " depends on itself");
+        continue;
+      }
+      if (std::find(node.dependencies.begin(), node.dependencies.end(),
+                    it->second) != node.dependencies.end()) {
+        continue;
+      }
+      node.dependencies.push_back(it->second);
+      nodes_[it->second].dependents.push_back(i);
+    }
+  }
+
+  Sort();
+  if (HasCycle()) {
+    FindCycle();
+  } else {
+    ComputeLevels();
+  }
+}
+
+size_t DependencyGraph::GetNodeCount() const { return nodes_.size(); }
+
+const std::shared_ptr<LoafItem>& DependencyGraph::GetItem(size_t index) const {
+  return nodes_[index].item;
+}
+
+bool DependencyGraph::FindIndex(const std::string& id, size_t* index) const {
+  auto it = index_by_id_.find(id);
+  if (it == index_by_id_.end()) {
+    return false;
+  }
+  if (index) {
+    *index = it->second;
+  }
+  return true;
+}
+
+const std::vector<size_t>& DependencyGraph::GetDependencies(
+    size_t index) const {
+  return nodes_[index].dependencies;
+}
+
+const std::vector<size_t>& DependencyGraph::GetDependents(size_t index) const {
+  return nodes_[index].dependents;
+}
+
+std::vector<size_t> DependencyGraph::GetTransitiveDependents(
+    size_t index) const {
+  std::vector<bool> seen(nodes_.size(), false);
+  std::vector<size_t> result;
+  std::vector<size_t> stack = {index};
+  seen[index] = true;
+  while (!stack.empty()) {
+    const size_t current = stack.back();
+    stack.pop_back();
+    for (size_t dependent : nodes_[current].dependents) {
+      if (!seen[dependent]) {
+        seen[dependent] = true;
+        result.push_back(dependent);
+        stack.push_back(dependent);
+      }
+    }
+  }
+  return result;
+}
+
+bool DependencyGraph::HasCycle() const { return order_.size() != nodes_.size(); }
+
+const std::vector<size_t>& DependencyGraph::GetTopologicalOrder() const {
+  return order_;
+}
+
+const std::vector<std::vector<size_t>>& DependencyGraph::GetLevels() const {
+  return levels_;
+}
+
+const std::vector<size_t>& DependencyGraph::GetCriticalPath() const {
+  return critical_path_;
+}
+
+const std::vector<std::string>& DependencyGraph::GetCycle() const {
+  return cycle_;
+}
+
+const std::vector<std::string>& DependencyGraph::GetWarnings() const {
+  return warnings_;
+}
+
+std::string DependencyGraph::DescribeCycle() const {
+  if (cycle_.empty()) {
+    return "";
+  }
+  std::string description = "Dependency cycle detected:";
+  for (const auto& id : cycle_) {
+    description += " " + id + " ->";
+  }
+  return description + " " + cycle_.front();
+}
+
+bool DependencyGraph::IsCurrent(
+    const std::vector<std::shared_ptr<LoafItem>>& items) const {
+  size_t index = 0;
+  for (const auto& item : items) {
+    if (!item) {
+      continue;
+    }
+    if (index >= nodes_.size() || nodes_[index].item != item ||
+        nodes_[index].revision != item->GetDependencyRevision()) {
+      return false;
+    }
+    ++index;
+  }
+  return index == nodes_.size();
+}
+
+void DependencyGraph::Sort() {
+  std::vector<size_t> remaining(nodes_.size());
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    remaining[i] = nodes_[i].dependencies.size();
+    if (remaining[i] == 0) {
+      order_.push_back(i);
+    }
+  }
+
+  for (size_t visited = 0; visited < order_.size(); ++visited) {
+    for (size_t dependent : nodes_[order_[visited]].dependents) {
+      if (--remaining[dependent] == 0) {
+        order_.push_back(dependent);
+      }
+    }
+  }
+}
+
+void DependencyGraph::FindCycle() {
+  enum class Mark { NONE, ACTIVE, DONE };
+  std::vector<Mark> marks(nodes_.size(), Mark::NONE);
+  std::vector<size_t> stack;
+
+  std::function<bool(size_t)> visit = [&](size_t index) {
+    marks[index] = Mark::ACTIVE;
+    stack.push_back(index);
+    for (size_t dependent : nodes_[index].dependents) {
+      if (marks[dependent] == Mark::ACTIVE) {
+        auto start = std::find(stack.begin(), stack.end(), dependent);
+        for (auto it = start; it != stack.end(); ++it) {
+          cycle_.push_back(nodes_[*it].item->GetId());
+        }
+        return true;
+      }
+      if (marks[dependent] == Mark::NONE && visit(dependent)) {
+        return true;
+      }
+    }
+    stack.pop_back();
+    marks[index] = Mark::DONE;
+    return false;
+  };
+
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    if (marks[i] == Mark::NONE && visit(i)) {
+      return;
+    }
+  }
+}
+
+std::vector<size_t> DependencyGraph::GetCriticalPath(
+    const std::vector<double>& weights) const {
+  std::vector<size_t> path;
+  if (HasCycle() || nodes_.empty() || weights.size() != nodes_.size()) {
+    return path;
+  }
+
+  std::vector<double> finish(nodes_.size(), 0.0);
+  std::vector<size_t> previous(nodes_.size(), nodes_.size());
+  for (size_t index : order_) {
+    for (size_t dependency : nodes_[index].dependencies) {
+      if (previous[index] == nodes_.size() ||
+          finish[dependency] > finish[previous[index]]) {
+        previous[index] = dependency;
+      }
+    }
+    const double start =
+        previous[index] == nodes_.size() ? 0.0 : finish[previous[index]];
+    finish[index] = start + weights[index];
+  }
+
+  size_t current = static_cast<size_t>(
+      std::max_element(finish.begin(), finish.end()) - finish.begin());
+  while (current != nodes_.size()) {
+    path.push_back(current);
+    current = previous[current];
+  }
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+void DependencyGraph::ComputeLevels() {
+  std::vector<size_t> level(nodes_.size(), 0);
+  for (size_t index : order_) {
+    for (size_t dependency : nodes_[index].dependencies) {
+      level[index] = std::max(level[index], level[dependency] + 1);
+    }
+    if (levels_.size() <= level[index]) {
+      levels_.resize(level[index] + 1);
+    }
+    levels_[level[index]].push_back(index);
+  }
+  critical_path_ = GetCriticalPath(std::vector<double>(nodes_.size(), 1.0));
+}
+
+}  // namespace BreadBin
@@ -0,0 +1,240 @@
+#include "LaunchScheduler.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#include "ReadinessProbe.h"
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace BreadBin {
+namespace {
+constexpr unsigned k_minimum_default_workers = 8;
+}  // namespace
+
+LaunchScheduler::LaunchScheduler(size_t max_workers, LaunchPolicy policy)
+    : max_workers_(max_workers),
+      policy_(policy),
+      running_workers_(0),
+      probing_workers_(0),
+      finished_(0),
+      failed_(false),
+      cancelled_(false),
+      cancel_descriptor_(-1) {
+#ifdef __linux__
+  cancel_descriptor_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+#endif
+  if (max_workers_ == 0) {
+    max_workers_ = std::max(k_minimum_default_workers,
+                            std::thread::hardware_concurrency());
+  }
+}
+
+LaunchScheduler::~LaunchScheduler() {
+#ifdef __linux__
+  if (cancel_descriptor_ >= 0) {
+    close(cancel_descriptor_);
+  }
+#endif
+}
+
+void LaunchScheduler::SetCompletionCallback(CompletionCallback callback) {
+  completion_callback_ = std::move(callback);
+}
+
+bool LaunchScheduler::Build(std::shared_ptr<const DependencyGraph> graph) {
+  graph_ = std::move(graph);
+  pending_.clear();
+  last_error_.clear();
+  report_ = LaunchReport();
+  if (!graph_) {
+    return true;
+  }
+  if (graph_->HasCycle()) {
+    last_error_ = graph_->DescribeCycle();
+    report_.error = last_error_;
+    return false;
+  }
+
+  pending_.resize(graph_->GetNodeCount());
+  return true;
+}
+
+bool LaunchScheduler::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  ready_.clear();
+  finished_ = 0;
+  failed_ = false;
+  settled_.assign(pending_.size(), false);
+  report_.items.assign(pending_.size(), ItemLaunchResult());
+  for (size_t i = 0; i < pending_.size(); ++i) {
+    const auto& item = graph_->GetItem(i);
+    item->ResetLaunchTimeline();
+    report_.items[i].item_id = item->GetId();
+    pending_[i] = graph_->GetDependencies(i).size();
+    if (pending_[i] == 0) {
+      item->RecordLaunchPhase(LaunchPhase::QUEUED);
+      ready_.push_back(i);
+    }
+  }
+
+  const size_t worker_count = std::min(max_workers_, pending_.size());
+  for (size_t i = 0; i < worker_count; ++i) {
+    StartWorker();
+  }
+  // Workers waiting on a readiness probe may start more workers, and only a
+  // live worker can do that, so joining until none are left catches them.
+  while (!workers_.empty()) {
+    std::thread worker = std::move(workers_.back());
+    workers_.pop_back();
+    lock.unlock();
+    worker.join();
+    lock.lock();
+  }
+
+  for (size_t i = 0; i < settled_.size(); ++i) {
+    if (!settled_[i]) {
+      report_.items[i].skipped = true;
+      report_.items[i].error = cancelled_ ? "Launch cancelled" : "Not started";
+    }
+  }
+  if (cancelled_) {
+    last_error_ = "Launch cancelled";
+  }
+  report_.success = !failed_ && !cancelled_;
+  report_.error = last_error_;
+  return report_.success;
+}
+
+void LaunchScheduler::Cancel() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cancelled_ = true;
+  condition_.notify_all();
+#ifdef __linux__
+  if (cancel_descriptor_ >= 0) {
+    const uint64_t value = 1;
+    [[maybe_unused]] const ssize_t written =
+        write(cancel_descriptor_, &value, sizeof(value));
+  }
+#endif
+}
+
+void LaunchScheduler::StartWorker() {
+  ++running_workers_;
+  workers_.emplace_back(&LaunchScheduler::WorkerLoop, this);
+}
+
+void LaunchScheduler::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    // A worker whose probe has finished retires if the pool grew past
+    // max_workers_ while it waited.
+    if (running_workers_ - probing_workers_ > max_workers_) {
+      --running_workers_;
+      return;
+    }
+    condition_.wait(lock, [this] {
+      return cancelled_ || (failed_ && policy_ == LaunchPolicy::FAIL_FAST) ||
+             !ready_.empty() || finished_ == pending_.size();
+    });
+    if (cancelled_ || (failed_ && policy_ == LaunchPolicy::FAIL_FAST) ||
+        ready_.empty()) {
+      --running_workers_;
+      return;
+    }
+
+    const size_t index = ready_.front();
+    ready_.pop_front();
+    settled_[index] = true;
+
+    lock.unlock();
+    const auto& item = graph_->GetItem(index);
+    const auto start = std::chrono::steady_clock::now();
+    ItemLaunchResult result;
+    result.item_id = item->GetId();
+    const ReadinessSpec readiness = ReadinessSpec::FromItem(*item);
+    ReadinessProbe probe(readiness);
+    result.launched = item->Execute();
+    if (!result.launched) {
+      result.error = item->GetLastError();
+    } else if (!readiness.IsEmpty() && !WaitUntilReady(*item, probe)) {
+      result.launched = false;
+      result.error = probe.GetError();
+    }
+    const auto finish = std::chrono::steady_clock::now();
+    result.latency =
+        std::chrono::duration_cast<std::chrono::microseconds>(finish - start);
+    if (result.launched) {
+      item->RecordLaunchPhase(LaunchPhase::READY, finish);
+    }
+    result.exit_code = item->GetLastExitCode();
+    if (completion_callback_) {
+      completion_callback_(item, result);
+    }
+    lock.lock();
+
+    ++finished_;
+    if (!result.launched) {
+      if (!failed_) {
+        last_error_ = "Failed to launch item: " + result.item_id;
+        if (!result.error.empty()) {
+          last_error_ += " (" + result.error + ")";
+        }
+      }
+      failed_ = true;
+      SkipDependents(index);
+    } else {
+      for (size_t dependent : graph_->GetDependents(index)) {
+        if (--pending_[dependent] == 0) {
+          graph_->GetItem(dependent)->RecordLaunchPhase(LaunchPhase::QUEUED);
+          ready_.push_back(dependent);
+        }
+      }
+    }
+    report_.items[index] = std::move(result);
+    condition_.notify_all();
+  }
+}
+
+bool LaunchScheduler::WaitUntilReady(LoafItem& item, ReadinessProbe& probe) {
+  // A probe can wait for up to its timeout without using the CPU, so it does
+  // not count against max_workers_; a new worker takes over its slot while
+  // items are still waiting to start.
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++probing_workers_;
+    if (running_workers_ - probing_workers_ < max_workers_ &&
+        std::find(settled_.begin(), settled_.end(), false) != settled_.end()) {
+      StartWorker();
+    }
+  }
+  const bool ready = probe.Wait(item, cancel_descriptor_);
+  std::lock_guard<std::mutex> lock(mutex_);
+  --probing_workers_;
+  return ready;
+}
+
+void LaunchScheduler::SkipDependents(size_t index) {
+  for (size_t dependent : graph_->GetTransitiveDependents(index)) {
+    if (settled_[dependent]) {
+      continue;
+    }
+    settled_[dependent] = true;
+    report_.items[dependent].skipped = true;
+    report_.items[dependent].error =
+        "Dependency failed: " + report_.items[index].item_id;
+    ++finished_;
+  }
+}
+
+size_t LaunchScheduler::GetWorkerCount() const { return max_workers_; }
+
+const LaunchReport& LaunchScheduler::GetReport() const { return report_; }
+
+std::string LaunchScheduler::GetLastError() const { return last_error_; }
+
+}  // namespace BreadBin
@@ -0,0 +1,120 @@
+#include "LaunchTrace.h"
+
+#include <utility>
+
+#include "AtomicFileWriter.h"
+#include "JsonString.h"
+
+namespace BreadBin {
+namespace {
+constexpr int k_trace_process_id = 1;
+
+long long ToMicroseconds(LaunchTimeline::Clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+      .count();
+}
+}  // namespace
+
+void LaunchTimeline::Record(LaunchPhase phase, Clock::time_point when) {
+  phases_[static_cast<size_t>(phase)] = when;
+}
+
+void LaunchTimeline::Reset() { phases_.fill(Clock::time_point()); }
+
+bool LaunchTimeline::Has(LaunchPhase phase) const {
+  return phases_[static_cast<size_t>(phase)] != Clock::time_point();
+}
+
+LaunchTimeline::Clock::time_point LaunchTimeline::Get(LaunchPhase phase) const {
+  return phases_[static_cast<size_t>(phase)];
+}
+
+LaunchTrace::LaunchTrace() = default;
+
+LaunchTrace::LaunchTrace(LaunchTimeline::Clock::time_point origin,
+                         std::vector<TraceEntry> entries)
+    : origin_(origin), entries_(std::move(entries)) {}
+
+LaunchTimeline::Clock::time_point LaunchTrace::GetOrigin() const {
+  return origin_;
+}
+
+const std::vector<TraceEntry>& LaunchTrace::GetEntries() const {
+  return entries_;
+}
+
+double LaunchTrace::GetOffsetMs(const LaunchTimeline& timeline,
+                                LaunchPhase phase) const {
+  return std::chrono::duration<double, std::milli>(timeline.Get(phase) -
+                                                   origin_)
+      .count();
+}
+
+std::string LaunchTrace::ToChromeTraceJson() const {
+  std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  auto append = [&](const std::string& event) {
+    if (!first) {
+      json += ",";
+    }
+    json += "\n" + event;
+    first = false;
+  };
+  auto complete = [&](size_t thread, const char* name,
+                      const LaunchTimeline& timeline, LaunchPhase from,
+                      LaunchPhase to) {
+    if (!timeline.Has(from) || !timeline.Has(to)) {
+      return;
+    }
+    append("{\"name\":\"" + std::string(name) +
+           "\",\"cat\":\"launch\",\"ph\":\"X\",\"pid\":" +
+           std::to_string(k_trace_process_id) +
+           ",\"tid\":" + std::to_string(thread) +
+           ",\"ts\":" + std::to_string(ToMicroseconds(timeline.Get(from) - origin_)) +
+           ",\"dur\":" +
+           std::to_string(ToMicroseconds(timeline.Get(to) - timeline.Get(from))) +
+           "}");
+  };
+
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    const auto& entry = entries_[i];
+    const size_t thread = i + 1;
+    std::string label;
+    AppendJsonString(label, entry.name.empty() ? entry.item_id : entry.name);
+    append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" +
+           std::to_string(k_trace_process_id) +
+           ",\"tid\":" + std::to_string(thread) +
+           ",\"args\":{\"name\":" + label + "}}");
+
+    const auto& timeline = entry.timeline;
+    complete(thread, "queued", timeline, LaunchPhase::QUEUED,
+             LaunchPhase::SPAWN_START);
+    complete(thread, "spawn", timeline, LaunchPhase::SPAWN_START,
+             LaunchPhase::SPAWN_DONE);
+    complete(thread, "startup", timeline, LaunchPhase::SPAWN_DONE,
+             LaunchPhase::READY);
+    if (!timeline.Has(LaunchPhase::SPAWN_START)) {
+      complete(thread, "execute", timeline, LaunchPhase::QUEUED,
+               LaunchPhase::READY);
+    }
+    if (timeline.Has(LaunchPhase::FIRST_OUTPUT)) {
+      append("{\"name\":\"first output\",\"cat\":\"launch\",\"ph\":\"i\","
+             "\"s\":\"t\",\"pid\":" +
+             std::to_string(k_trace_process_id) +
+             ",\"tid\":" + std::to_string(thread) + ",\"ts\":" +
+             std::to_string(ToMicroseconds(
+                 timeline.Get(LaunchPhase::FIRST_OUTPUT) - origin_)) +
+             "}");
+    }
+  }
+
+  json += "\n]}\n";
+  return json;
+}
+
+bool LaunchTrace::ExportChromeTrace(const std::string& filepath) const {
+  return AtomicFileWriter::WriteFile(filepath, ToChromeTraceJson(),
+                                     SyncPolicy::NONE);
+}
+
+}  // namespace BreadBin
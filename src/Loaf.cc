@@ -1,28 +1,59 @@
 #include "Loaf.h"
 
 #include <algorithm>
+#include <charconv>
+#include <chrono>
 #include <fstream>
+#include <thread>
+#include <utility>
+
+#ifndef _WIN32
+#include <poll.h>
+#endif
+
+#include "AtomicFileWriter.h"
+#include "LaunchScheduler.h"
+#include "LoafBinaryFormat.h"
+#include "LoafTextParser.h"
+#include "MappedFile.h"
 
 namespace BreadBin {
 namespace {
-std::shared_ptr<LoafItem> CreateItemByType(const std::string& type,
-                                           const std::string& id) {
-  if (type == "APPLICATION") {
-    return std::make_shared<ApplicationItem>(id);
-  }
-  if (type == "FILE") {
-    return std::make_shared<FileItem>(id);
-  }
-  if (type == "CONFIG") {
-    return std::make_shared<ConfigItem>(id);
-  }
-  if (type == "SCRIPT") {
-    return std::make_shared<ScriptItem>(id);
+constexpr int k_default_stop_timeout_ms = 3000;
+constexpr int k_stop_poll_interval_ms = 20;
+
+size_t ParseWorkerCount(const std::string& value) {
+  size_t count = 0;
+  std::from_chars(value.data(), value.data() + value.size(), count);
+  return count;
+}
+
+int ParseStopTimeout(const std::string& value) {
+  int timeout = k_default_stop_timeout_ms;
+  std::from_chars(value.data(), value.data() + value.size(), timeout);
+  return std::max(0, timeout);
+}
+
+void WaitForAnyExit(const std::vector<std::shared_ptr<LoafItem>>& items,
+                    int timeout_ms) {
+#ifndef _WIN32
+  std::vector<pollfd> descriptors;
+  descriptors.reserve(items.size());
+  for (const auto& item : items) {
+    const int descriptor = item->GetPollDescriptor();
+    if (descriptor < 0) {
+      descriptors.clear();
+      break;
+    }
+    descriptors.push_back(pollfd{descriptor, POLLIN, 0});
   }
-  if (type == "WEBPAGE") {
-    return std::make_shared<WebPageItem>(id);
+  if (!descriptors.empty()) {
+    poll(descriptors.data(), descriptors.size(), timeout_ms);
+    return;
   }
-  return nullptr;
+#endif
+  std::this_thread::sleep_for(std::chrono::milliseconds(
+      std::min(timeout_ms, k_stop_poll_interval_ms)));
 }
 
 std::string ToTypeString(LoafItem::Type type) {
@@ -47,110 +78,48 @@ Loaf::Loaf()
     : name_("Untitled Loaf"),
       description_(""),
       layout_("default"),
-      running_(false) {}
+      running_(false),
+      launching_(false),
+      supervising_(false) {}
 
 Loaf::Loaf(const std::string& name)
-    : name_(name), description_(""), layout_("default"), running_(false) {}
+    : name_(name),
+      description_(""),
+      layout_("default"),
+      running_(false),
+      launching_(false),
+      supervising_(false) {}
 
 Loaf::~Loaf() {
-  if (running_) {
-    Stop();
-  }
+  Stop();
+  WaitForLaunch();
+  monitor_.reset();
 }
 
 bool Loaf::Load(const std::string& filepath) {
-  std::ifstream file(filepath);
-  if (!file.is_open()) {
-    return false;
+  if (LoafBinaryReader::IsBinaryLoaf(filepath)) {
+    return LoadBinary(filepath);
   }
 
-  Clear();
-
-  std::getline(file, name_);
-  std::getline(file, description_);
-  std::getline(file, layout_);
-
-  int ruleCount = 0;
-  file >> ruleCount;
-  file.ignore();
-
-  for (int i = 0; i < ruleCount; ++i) {
-    std::string key, value;
-    std::getline(file, key);
-    std::getline(file, value);
-    runtime_rules_[key] = value;
-  }
-
-  int itemCount = 0;
-  if (!(file >> itemCount)) {
-    return true;
+  MappedFile file;
+  if (!file.Open(filepath)) {
+    last_error_ = filepath + ": cannot open file";
+    return false;
   }
-  file.ignore();
 
-  for (int i = 0; i < itemCount; ++i) {
-    std::string type_line;
-    std::getline(file, type_line);
-    if (type_line.rfind("TYPE:", 0) != 0) {
-      continue;
-    }
-
-    std::string id_line;
-    std::getline(file, id_line);
-    if (id_line.rfind("ID:", 0) != 0) {
-      continue;
-    }
-
-    std::string name_line;
-    std::getline(file, name_line);
-    std::string path_line;
-    std::getline(file, path_line);
-
-    const std::string type = type_line.substr(5);
-    const std::string id = id_line.substr(3);
-    auto item = CreateItemByType(type, id);
-    if (!item) {
-      continue;
-    }
-
-    if (name_line.rfind("NAME:", 0) == 0) {
-      item->SetName(name_line.substr(5));
-    }
-    if (path_line.rfind("PATH:", 0) == 0) {
-      item->SetPath(path_line.substr(5));
-    }
-
-    std::string meta_count_line;
-    std::getline(file, meta_count_line);
-    int meta_count = 0;
-    if (meta_count_line.rfind("META_COUNT:", 0) == 0) {
-      meta_count = std::stoi(meta_count_line.substr(11));
-    }
-
-    for (int m = 0; m < meta_count; ++m) {
-      std::string key_line;
-      std::string value_line;
-      std::getline(file, key_line);
-      std::getline(file, value_line);
-
-      if (key_line.rfind("META_KEY:", 0) == 0 &&
-          value_line.rfind("META_VALUE:", 0) == 0) {
-        item->SetMetadata(key_line.substr(9), value_line.substr(11));
-      }
-    }
-
-    std::string end_marker;
-    std::getline(file, end_marker);
-    AddItem(item);
+  Clear();
+  LoafTextParser parser(file.GetData());
+  if (!parser.Parse(this)) {
+    last_error_ = filepath + ":" + parser.GetError().ToString();
+    return false;
   }
-
+  last_error_.clear();
   return true;
 }
 
 bool Loaf::Save(const std::string& filepath) const {
-  std::ofstream file(filepath);
-  if (!file.is_open()) {
-    return false;
-  }
+  AtomicFileWriter writer(filepath);
+  std::ostream& file = writer.Stream();
 
   file << name_ << "\n";
   file << description_ << "\n";
@@ -173,24 +142,9 @@ bool Loaf::Save(const std::string& filepath) const {
     file << "NAME:" << item->GetName() << "\n";
     file << "PATH:" << item->GetPath() << "\n";
 
-    const std::map<std::string, std::string> metadata = {
-        {"depends_on", item->GetMetadata("depends_on")},
-        {"args", item->GetMetadata("args")},
-        {"working_dir", item->GetMetadata("working_dir")},
-        {"auto_start", item->GetMetadata("auto_start")}};
-
-    size_t metadata_count = 0;
-    for (const auto& pair : metadata) {
-      if (!pair.second.empty()) {
-        ++metadata_count;
-      }
-    }
-
-    file << "META_COUNT:" << metadata_count << "\n";
+    const auto& metadata = item->GetAllMetadata();
+    file << "META_COUNT:" << metadata.size() << "\n";
     for (const auto& pair : metadata) {
-      if (pair.second.empty()) {
-        continue;
-      }
       file << "META_KEY:" << pair.first << "\n";
       file << "META_VALUE:" << pair.second << "\n";
     }
@@ -198,42 +152,107 @@ bool Loaf::Save(const std::string& filepath) const {
     file << "END_ITEM\n";
   }
 
+  return writer.Commit();
+}
+
+bool Loaf::LoadBinary(const std::string& filepath) {
+  LoafBinaryReader reader;
+  if (!reader.Open(filepath)) {
+    last_error_ = filepath + ": malformed or truncated binary loaf";
+    return false;
+  }
+
+  Clear();
+  const LoafSummary& summary = reader.GetSummary();
+  name_ = summary.name;
+  description_ = summary.description;
+  layout_ = summary.layout;
+  runtime_rules_ = reader.GetRuntimeRules();
+
+  // A full load builds every item up front: GetItems(), the id index and the
+  // dependency graph all need the whole set. Only the summary is read without
+  // touching the item records (see ReadSummary).
+  items_.reserve(summary.item_count);
+  for (size_t i = 0; i < summary.item_count; ++i) {
+    auto item = reader.ReadItem(i);
+    if (!item) {
+      last_error_ = filepath + ": malformed item " + std::to_string(i);
+      return false;
+    }
+    if (!AddItem(item)) {
+      last_error_ = filepath + ": duplicate item id '" + item->GetId() + "'";
+      return false;
+    }
+  }
   return true;
 }
 
+bool Loaf::SaveBinary(const std::string& filepath) const {
+  return LoafBinaryWriter::Write(*this, filepath);
+}
+
+bool Loaf::ReadSummary(const std::string& filepath, LoafSummary* summary) {
+  if (!summary) {
+    return false;
+  }
+  if (LoafBinaryReader::IsBinaryLoaf(filepath)) {
+    return LoafBinaryReader::ReadSummary(filepath, summary);
+  }
+
+  MappedFile file;
+  if (!file.Open(filepath)) {
+    return false;
+  }
+  LoafTextParser parser(file.GetData());
+  return parser.ParseSummary(summary);
+}
+
 void Loaf::Clear() {
   items_.clear();
+  item_index_.clear();
   runtime_rules_.clear();
   running_ = false;
 }
 
-void Loaf::AddItem(std::shared_ptr<LoafItem> item) {
-  if (item) {
-    items_.push_back(item);
+bool Loaf::AddItem(std::shared_ptr<LoafItem> item) {
+  if (!item || !item_index_.emplace(item->GetId(), item).second) {
+    return false;
+  }
+  items_.push_back(std::move(item));
+  return true;
+}
+
+bool Loaf::RemoveItem(const std::string& itemId) {
+  auto it = item_index_.find(itemId);
+  if (it == item_index_.end()) {
+    return false;
   }
+  items_.erase(std::find(items_.begin(), items_.end(), it->second));
+  item_index_.erase(it);
+  return true;
 }
 
-void Loaf::RemoveItem(const std::string& itemId) {
-  items_.erase(std::remove_if(items_.begin(), items_.end(),
-                              [&itemId](const std::shared_ptr<LoafItem>& item) {
-                                return item && item->GetId() == itemId;
-                              }),
-               items_.end());
+bool Loaf::HasItem(const std::string& itemId) const {
+  return item_index_.count(itemId) != 0;
 }
 
 std::shared_ptr<LoafItem> Loaf::GetItem(const std::string& itemId) const {
-  for (const auto& item : items_) {
-    if (item && item->GetId() == itemId) {
-      return item;
-    }
-  }
-  return nullptr;
+  auto it = item_index_.find(itemId);
+  return (it != item_index_.end()) ? it->second : nullptr;
 }
 
 const std::vector<std::shared_ptr<LoafItem>>& Loaf::GetItems() const {
   return items_;
 }
 
+std::shared_ptr<const DependencyGraph> Loaf::GetDependencyGraph() const {
+  std::lock_guard<std::mutex> lock(graph_mutex_);
+  if (!graph_ || !graph_->IsCurrent(items_)) {
+    graph_ = std::make_shared<const DependencyGraph>(items_);
+  }
+  return graph_;
+}
+
 void Loaf::SetName(const std::string& name) { name_ = name; }
 
 std::string Loaf::GetName() const { return name_; }
@@ -257,30 +276,357 @@ std::string Loaf::GetRuntimeRule(const std::string& key) const {
   return (it != runtime_rules_.end()) ? it->second : "";
 }
 
-bool Loaf::Run() {
-  if (running_) {
-    return false;
+const std::map<std::string, std::string>& Loaf::GetRuntimeRules() const {
+  return runtime_rules_;
+}
+
+bool Loaf::Run() { return RunAsync().get().success; }
+
+std::future<LaunchReport> Loaf::RunAsync() {
+  RunOptions options;
+  options.policy = GetLaunchPolicy();
+  return RunAsync(std::move(options));
+}
+
+std::future<LaunchReport> Loaf::RunAsync(RunOptions options) {
+  std::promise<LaunchReport> promise;
+  auto future = promise.get_future();
+
+  // The previous launch thread may still be inside on_finished, which is
+  // allowed to call back into this loaf, so join it without the lock held.
+  std::unique_lock<std::mutex> lock(launch_mutex_);
+  while (!running_ && !launching_ && launch_thread_.joinable()) {
+    std::thread previous_thread = std::move(launch_thread_);
+    lock.unlock();
+    previous_thread.join();
+    lock.lock();
+  }
+  if (running_ || launching_) {
+    LaunchReport report;
+    report.error = "Loaf is already running";
+    lock.unlock();
+    if (options.on_finished) {
+      options.on_finished(report);
+    }
+    promise.set_value(std::move(report));
+    return future;
   }
 
-  for (const auto& item : items_) {
-    if (item && !item->Execute()) {
-      return false;
+  last_error_.clear();
+  if (!monitor_) {
+    monitor_ = std::make_unique<ProcessMonitor>(
+        [this](const ItemEvent& event) { OnProcessEvent(event); });
+  }
+  monitor_->Start();
+
+  auto scheduler = std::make_shared<LaunchScheduler>(
+      ParseWorkerCount(GetRuntimeRule("max_parallel")), options.policy);
+  scheduler->SetCompletionCallback(
+      [this, on_item_result = options.on_item_result](
+          const std::shared_ptr<LoafItem>& item,
+          const ItemLaunchResult& result) {
+        OnItemLaunched(item, result);
+        if (on_item_result) {
+          on_item_result(result);
+        }
+      });
+  if (!scheduler->Build(GetDependencyGraph())) {
+    last_error_ = scheduler->GetLastError();
+    LaunchReport report = scheduler->GetReport();
+    lock.unlock();
+    if (options.on_finished) {
+      options.on_finished(report);
     }
+    promise.set_value(std::move(report));
+    return future;
   }
 
-  running_ = true;
-  return true;
+  {
+    std::lock_guard<std::mutex> restart_lock(restart_mutex_);
+    restart_trackers_.clear();
+    supervising_ = true;
+  }
+  launching_ = true;
+  active_scheduler_ = scheduler;
+  launch_origin_ = LaunchTimeline::Clock::now();
+  launch_thread_ = std::thread(
+      [this, scheduler, options = std::move(options),
+       promise = std::move(promise)]() mutable {
+        LaunchReport report = Launch(*scheduler, options.policy);
+        if (options.on_finished) {
+          options.on_finished(report);
+        }
+        promise.set_value(std::move(report));
+      });
+  return future;
+}
+
+LaunchReport Loaf::Launch(LaunchScheduler& scheduler, LaunchPolicy policy) {
+  const bool success = scheduler.Run();
+  LaunchReport report = scheduler.GetReport();
+  if (!success && policy == LaunchPolicy::FAIL_FAST) {
+    StopSupervising();
+    StopProcesses();
+  }
+
+  // Items that were spawned but failed stay supervised, since their restart
+  // policy may bring them back.
+  const bool any_launched =
+      std::any_of(
+          report.items.begin(), report.items.end(),
+          [](const ItemLaunchResult& result) { return result.launched; }) ||
+      std::any_of(items_.begin(), items_.end(), [](const auto& item) {
+        return item && item->GetLaunchTimeline().Has(LaunchPhase::SPAWN_DONE);
+      });
+  if (!success && !any_launched) {
+    StopSupervising();
+  }
+
+  std::lock_guard<std::mutex> lock(launch_mutex_);
+  last_error_ = report.error;
+  active_scheduler_.reset();
+  running_ = success ||
+             (policy == LaunchPolicy::CONTINUE_ON_ERROR && any_launched);
+  launching_ = false;
+  return report;
 }
 
 bool Loaf::Stop() {
-  if (!running_) {
-    return false;
+  std::thread launch_thread;
+  {
+    std::lock_guard<std::mutex> lock(launch_mutex_);
+    if (!running_ && !launching_) {
+      return false;
+    }
+    if (active_scheduler_) {
+      active_scheduler_->Cancel();
+    }
+    launch_thread = std::move(launch_thread_);
+  }
+
+  StopSupervising();
+  StopProcesses();
+  if (launch_thread.joinable()) {
+    launch_thread.join();
+    StopProcesses();
   }
 
   running_ = false;
   return true;
 }
 
+void Loaf::WaitForLaunch() {
+  std::thread launch_thread;
+  {
+    std::lock_guard<std::mutex> lock(launch_mutex_);
+    launch_thread = std::move(launch_thread_);
+  }
+  if (launch_thread.joinable()) {
+    launch_thread.join();
+  }
+}
+
+void Loaf::StopSupervising() {
+  {
+    std::lock_guard<std::mutex> lock(restart_mutex_);
+    supervising_ = false;
+  }
+  if (monitor_) {
+    monitor_->CancelScheduled();
+  }
+}
+
+void Loaf::StopProcesses() {
+  std::vector<std::shared_ptr<LoafItem>> stopping;
+  for (const auto& item : items_) {
+    if (item && item->TerminateProcess()) {
+      stopping.push_back(item);
+    }
+  }
+
+  const auto deadline =
+      std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(
+          ParseStopTimeout(GetRuntimeRule("stop_timeout_ms")));
+  while (true) {
+    std::erase_if(stopping, [](const std::shared_ptr<LoafItem>& item) {
+      return !item->IsProcessRunning();
+    });
+    const auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now())
+            .count();
+    if (stopping.empty() || remaining <= 0) {
+      break;
+    }
+    WaitForAnyExit(stopping, static_cast<int>(remaining));
+  }
+
+  for (const auto& item : stopping) {
+    item->KillProcess();
+  }
+}
+
 bool Loaf::IsRunning() const { return running_; }
 
+bool Loaf::IsLaunching() const { return launching_; }
+
+LaunchPolicy Loaf::GetLaunchPolicy() const {
+  return GetRuntimeRule("on_error") == "continue"
+             ? LaunchPolicy::CONTINUE_ON_ERROR
+             : LaunchPolicy::FAIL_FAST;
+}
+
+LaunchTrace Loaf::GetLaunchTrace() const {
+  std::vector<TraceEntry> entries;
+  entries.reserve(items_.size());
+  for (const auto& item : items_) {
+    if (item) {
+      entries.push_back(
+          TraceEntry{item->GetId(), item->GetName(), item->GetLaunchTimeline()});
+    }
+  }
+  std::lock_guard<std::mutex> lock(launch_mutex_);
+  return LaunchTrace(launch_origin_, std::move(entries));
+}
+
+std::vector<std::string> Loaf::GetLaunchCriticalPath() const {
+  const auto graph = GetDependencyGraph();
+  std::vector<double> weights(graph->GetNodeCount(), 0.0);
+  for (size_t i = 0; i < weights.size(); ++i) {
+    const LaunchTimeline timeline = graph->GetItem(i)->GetLaunchTimeline();
+    if (timeline.Has(LaunchPhase::QUEUED) && timeline.Has(LaunchPhase::READY)) {
+      weights[i] = std::chrono::duration<double, std::milli>(
+                       timeline.Get(LaunchPhase::READY) -
+                       timeline.Get(LaunchPhase::QUEUED))
+                       .count();
+    }
+  }
+
+  std::vector<std::string> path;
+  for (size_t index : graph->GetCriticalPath(weights)) {
+    path.push_back(graph->GetItem(index)->GetId());
+  }
+  return path;
+}
+
+std::string Loaf::GetLastError() const {
+  std::lock_guard<std::mutex> lock(launch_mutex_);
+  return last_error_;
+}
+
+int Loaf::GetRestartCount(const std::string& itemId) const {
+  std::lock_guard<std::mutex> lock(restart_mutex_);
+  auto it = restart_trackers_.find(itemId);
+  return (it != restart_trackers_.end()) ? it->second.GetRestartCount() : 0;
+}
+
+void Loaf::SetItemEventCallback(ProcessMonitor::Callback callback) {
+  std::lock_guard<std::mutex> lock(event_mutex_);
+  event_callback_ = std::move(callback);
+}
+
+void Loaf::NotifyItemEvent(const ItemEvent& event) {
+  std::lock_guard<std::mutex> lock(event_mutex_);
+  if (event_callback_) {
+    event_callback_(event);
+  }
+}
+
+void Loaf::OnProcessEvent(const ItemEvent& event) {
+  auto item = GetItem(event.item_id);
+  if (event.state != ItemState::EXITED || !item) {
+    NotifyItemEvent(event);
+    return;
+  }
+
+  const RestartPolicy policy = RestartPolicy::FromItem(*item);
+  ItemEvent reported = event;
+  std::chrono::milliseconds delay{0};
+  bool restart = false;
+  {
+    std::lock_guard<std::mutex> lock(restart_mutex_);
+    auto& tracker = restart_trackers_[event.item_id];
+    restart = supervising_ && policy.ShouldRestart(event.exit_code) &&
+              tracker.NextDelay(policy, RestartTracker::Clock::now(), &delay);
+    reported.restart_count = tracker.GetRestartCount();
+  }
+
+  if (restart) {
+    reported.state = ItemState::RESTARTING;
+  }
+  NotifyItemEvent(reported);
+  if (restart) {
+    monitor_->ScheduleAfter(delay, [this, item_id = event.item_id]() {
+      RestartItem(item_id);
+    });
+  }
+}
+
+void Loaf::RestartItem(const std::string& itemId) {
+  auto item = GetItem(itemId);
+  {
+    std::lock_guard<std::mutex> lock(restart_mutex_);
+    if (!supervising_ || !item) {
+      return;
+    }
+  }
+
+  // Runs on the monitor thread, so spawn without waiting for scripts to exit
+  // and without holding restart_mutex_ across the launch.
+  const bool executed = item->Execute(false);
+  const bool started = executed && item->IsProcessRunning();
+  bool supervising = false;
+  int restart_count = 0;
+  {
+    std::lock_guard<std::mutex> lock(restart_mutex_);
+    supervising = supervising_;
+    restart_count = restart_trackers_[itemId].GetRestartCount();
+  }
+
+  if (!supervising) {
+    // Stop() may already have swept the items before this spawn happened.
+    if (started) {
+      item->KillProcess();
+    }
+    return;
+  }
+  if (started) {
+    NotifyItemEvent(ItemEvent{itemId, ItemState::RUNNING, 0, restart_count});
+    monitor_->Watch(item);
+    return;
+  }
+  OnProcessEvent(ItemEvent{itemId, ItemState::EXITED,
+                           executed ? item->GetLastExitCode() : -1,
+                           restart_count});
+}
+
+void Loaf::OnItemLaunched(const std::shared_ptr<LoafItem>& item,
+                          const ItemLaunchResult& result) {
+  const bool spawned =
+      item->GetLaunchTimeline().Has(LaunchPhase::SPAWN_DONE);
+  const bool running = spawned && item->IsProcessRunning();
+  if (!result.launched && (!spawned || running)) {
+    NotifyItemEvent(
+        ItemEvent{item->GetId(), ItemState::FAILED, result.exit_code});
+    return;
+  }
+
+  if (running) {
+    NotifyItemEvent(ItemEvent{item->GetId(), ItemState::RUNNING, 0});
+    monitor_->Watch(item);
+    return;
+  }
+  if (!spawned) {
+    NotifyItemEvent(
+        ItemEvent{item->GetId(), ItemState::EXITED, item->GetLastExitCode()});
+    return;
+  }
+
+  // The process has already been reaped, so the monitor never sees this exit;
+  // route it through the restart policy like any other.
+  OnProcessEvent(
+      ItemEvent{item->GetId(), ItemState::EXITED, item->GetLastExitCode()});
+}
+
 }  // namespace BreadBin
\ No newline at end of file
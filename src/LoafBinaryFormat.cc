@@ -0,0 +1,233 @@
+#include "LoafBinaryFormat.h"
+
+#include <cstring>
+
+#include "AtomicFileWriter.h"
+#include "ByteCodec.h"
+#include "Loaf.h"
+
+namespace BreadBin {
+namespace {
+constexpr char k_magic[8] = {'B', 'B', 'L', 'O', 'A', 'F', '\0', '\n'};
+constexpr size_t k_prefix_size = sizeof(k_magic) + 2 * sizeof(uint32_t);
+constexpr size_t k_entry_size = sizeof(uint64_t) + sizeof(uint32_t);
+constexpr size_t k_initial_read_size = 4096;
+
+bool ReadExactly(std::ifstream& file, char* buffer, size_t size) {
+  file.read(buffer, static_cast<std::streamsize>(size));
+  return static_cast<size_t>(file.gcount()) == size;
+}
+
+uint64_t GetFileSize(std::ifstream& file) {
+  file.seekg(0, std::ios::end);
+  const std::streamoff size = file.tellg();
+  file.seekg(0, std::ios::beg);
+  return size > 0 ? static_cast<uint64_t>(size) : 0;
+}
+
+// Every size read from the file is checked against file_size before it is
+// used to allocate, so a corrupt file fails to open instead of throwing.
+bool ReadHeader(std::ifstream& file, uint64_t file_size, LoafSummary* summary,
+                std::map<std::string, std::string>* runtime_rules) {
+  std::string buffer(k_initial_read_size, '\0');
+  file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  buffer.resize(static_cast<size_t>(file.gcount()));
+  if (buffer.size() < k_prefix_size ||
+      std::memcmp(buffer.data(), k_magic, sizeof(k_magic)) != 0) {
+    return false;
+  }
+
+  ByteReader prefix(std::string_view(buffer).substr(
+      sizeof(k_magic), k_prefix_size - sizeof(k_magic)));
+  const auto version = static_cast<uint32_t>(prefix.ReadInteger(4));
+  const auto header_size = static_cast<size_t>(prefix.ReadInteger(4));
+  if (version != LoafBinaryReader::k_version ||
+      header_size > file_size - k_prefix_size) {
+    return false;
+  }
+
+  const size_t available = buffer.size() - k_prefix_size;
+  if (header_size > available) {
+    const size_t missing = header_size - available;
+    buffer.resize(buffer.size() + missing);
+    file.clear();
+    if (!ReadExactly(file, buffer.data() + k_prefix_size + available,
+                     missing)) {
+      return false;
+    }
+  }
+
+  ByteReader header(
+      std::string_view(buffer).substr(k_prefix_size, header_size));
+  summary->name = header.ReadString();
+  summary->description = header.ReadString();
+  summary->layout = header.ReadString();
+  const auto rule_count = header.ReadInteger(4);
+  for (uint64_t i = 0; i < rule_count && header.IsValid(); ++i) {
+    std::string key = header.ReadString();
+    std::string value = header.ReadString();
+    if (runtime_rules) {
+      (*runtime_rules)[key] = value;
+    }
+  }
+  summary->item_count = static_cast<size_t>(header.ReadInteger(4));
+
+  file.clear();
+  file.seekg(static_cast<std::streamoff>(k_prefix_size + header_size));
+  return header.IsValid();
+}
+}  // namespace
+
+LoafBinaryReader::LoafBinaryReader() = default;
+
+LoafBinaryReader::~LoafBinaryReader() = default;
+
+bool LoafBinaryReader::Open(const std::string& filepath) {
+  file_.close();
+  file_.open(filepath, std::ios::binary);
+  summary_ = LoafSummary();
+  runtime_rules_.clear();
+  entries_.clear();
+  if (!file_.is_open()) {
+    return false;
+  }
+  const uint64_t file_size = GetFileSize(file_);
+  if (!ReadHeader(file_, file_size, &summary_, &runtime_rules_)) {
+    return false;
+  }
+
+  const auto table_offset = static_cast<uint64_t>(file_.tellg());
+  if (table_offset > file_size ||
+      summary_.item_count > (file_size - table_offset) / k_entry_size) {
+    return false;
+  }
+  std::string table(summary_.item_count * k_entry_size, '\0');
+  if (!ReadExactly(file_, table.data(), table.size())) {
+    return false;
+  }
+
+  ByteReader reader(table);
+  entries_.reserve(summary_.item_count);
+  for (size_t i = 0; i < summary_.item_count; ++i) {
+    Entry entry{};
+    entry.offset = reader.ReadInteger(sizeof(uint64_t));
+    entry.size = static_cast<uint32_t>(reader.ReadInteger(sizeof(uint32_t)));
+    if (entry.offset > file_size || entry.size > file_size - entry.offset) {
+      return false;
+    }
+    entries_.push_back(entry);
+  }
+  return reader.IsValid();
+}
+
+const LoafSummary& LoafBinaryReader::GetSummary() const { return summary_; }
+
+const std::map<std::string, std::string>& LoafBinaryReader::GetRuntimeRules()
+    const {
+  return runtime_rules_;
+}
+
+std::shared_ptr<LoafItem> LoafBinaryReader::ReadItem(size_t index) {
+  if (index >= entries_.size() || !file_.is_open()) {
+    return nullptr;
+  }
+
+  const Entry& entry = entries_[index];
+  std::string record(entry.size, '\0');
+  file_.clear();
+  file_.seekg(static_cast<std::streamoff>(entry.offset));
+  if (!ReadExactly(file_, record.data(), record.size())) {
+    return nullptr;
+  }
+
+  ByteReader reader(record);
+  const auto type = static_cast<LoafItem::Type>(reader.ReadInteger(1));
+  const std::string id = reader.ReadString();
+  auto item = LoafItem::Create(type, id);
+  if (!item) {
+    return nullptr;
+  }
+
+  item->SetName(reader.ReadString());
+  item->SetPath(reader.ReadString());
+  const auto metadata_count = reader.ReadInteger(4);
+  for (uint64_t i = 0; i < metadata_count && reader.IsValid(); ++i) {
+    std::string key = reader.ReadString();
+    std::string value = reader.ReadString();
+    if (reader.IsValid()) {
+      item->SetMetadata(key, value);
+    }
+  }
+
+  return reader.IsValid() ? item : nullptr;
+}
+
+bool LoafBinaryReader::IsBinaryLoaf(const std::string& filepath) {
+  std::ifstream file(filepath, std::ios::binary);
+  char magic[sizeof(k_magic)] = {};
+  return file.is_open() && ReadExactly(file, magic, sizeof(magic)) &&
+         std::memcmp(magic, k_magic, sizeof(k_magic)) == 0;
+}
+
+bool LoafBinaryReader::ReadSummary(const std::string& filepath,
+                                   LoafSummary* summary) {
+  std::ifstream file(filepath, std::ios::binary);
+  return file.is_open() && summary &&
+         ReadHeader(file, GetFileSize(file), summary, nullptr);
+}
+
+bool LoafBinaryWriter::Write(const Loaf& loaf, const std::string& filepath) {
+  std::string header;
+  WriteString(header, loaf.GetName());
+  WriteString(header, loaf.GetDescription());
+  WriteString(header, loaf.GetLayout());
+  const auto& runtime_rules = loaf.GetRuntimeRules();
+  WriteInteger(header, runtime_rules.size(), 4);
+  for (const auto& rule : runtime_rules) {
+    WriteString(header, rule.first);
+    WriteString(header, rule.second);
+  }
+
+  std::vector<std::string> records;
+  for (const auto& item : loaf.GetItems()) {
+    if (!item) {
+      continue;
+    }
+
+    std::string record;
+    WriteInteger(record, static_cast<uint64_t>(item->GetType()), 1);
+    WriteString(record, item->GetId());
+    WriteString(record, item->GetName());
+    WriteString(record, item->GetPath());
+
+    const auto& metadata = item->GetAllMetadata();
+    WriteInteger(record, metadata.size(), 4);
+    for (const auto& pair : metadata) {
+      WriteString(record, pair.first);
+      WriteString(record, pair.second);
+    }
+    records.push_back(std::move(record));
+  }
+  WriteInteger(header, records.size(), 4);
+
+  std::string output(k_magic, sizeof(k_magic));
+  WriteInteger(output, LoafBinaryReader::k_version, 4);
+  WriteInteger(output, header.size(), 4);
+  output += header;
+
+  uint64_t offset =
+      k_prefix_size + header.size() + records.size() * k_entry_size;
+  for (const auto& record : records) {
+    WriteInteger(output, offset, sizeof(uint64_t));
+    WriteInteger(output, record.size(), sizeof(uint32_t));
+    offset += record.size();
+  }
+  for (const auto& record : records) {
+    output += record;
+  }
+
+  return AtomicFileWriter::WriteFile(filepath, output,
+                                     AtomicFileWriter::GetDefaultSyncPolicy());
+}
+
+}  // namespace BreadBin
\ No newline at end of file
@@ -27,7 +27,10 @@ bool LoafEditor::SaveLoaf(const std::string& filepath) {
     return false;
   }
 
-  if (current_loaf_->Save(filepath)) {
+  const bool binary = filepath.size() > 6 &&
+                      filepath.compare(filepath.size() - 6, 6, ".loafb") == 0;
+  if (binary ? current_loaf_->SaveBinary(filepath)
+             : current_loaf_->Save(filepath)) {
     unsaved_changes_ = false;
     return true;
   }
@@ -49,7 +52,9 @@ bool LoafEditor::AddApplication(const std::string& id, const std::string& name,
   auto item = std::make_shared<ApplicationItem>(id);
   item->SetName(name);
   item->SetPath(path);
-  current_loaf_->AddItem(item);
+  if (!current_loaf_->AddItem(item)) {
+    return false;
+  }
   unsaved_changes_ = true;
   return true;
 }
@@ -63,7 +68,9 @@ bool LoafEditor::AddFile(const std::string& id, const std::string& name,
   auto item = std::make_shared<FileItem>(id);
   item->SetName(name);
   item->SetPath(path);
-  current_loaf_->AddItem(item);
+  if (!current_loaf_->AddItem(item)) {
+    return false;
+  }
   unsaved_changes_ = true;
   return true;
 }
@@ -77,7 +84,9 @@ bool LoafEditor::AddConfig(const std::string& id, const std::string& name,
   auto item = std::make_shared<ConfigItem>(id);
   item->SetName(name);
   item->SetPath(path);
-  current_loaf_->AddItem(item);
+  if (!current_loaf_->AddItem(item)) {
+    return false;
+  }
   unsaved_changes_ = true;
   return true;
 }
@@ -91,7 +100,9 @@ bool LoafEditor::AddScript(const std::string& id, const std::string& name,
   auto item = std::make_shared<ScriptItem>(id);
   item->SetName(name);
   item->SetPath(path);
-  current_loaf_->AddItem(item);
+  if (!current_loaf_->AddItem(item)) {
+    return false;
+  }
   unsaved_changes_ = true;
   return true;
 }
@@ -105,7 +116,9 @@ bool LoafEditor::AddWebPage(const std::string& id, const std::string& name,
   auto item = std::make_shared<WebPageItem>(id);
   item->SetName(name);
   item->SetPath(url);
-  current_loaf_->AddItem(item);
+  if (!current_loaf_->AddItem(item)) {
+    return false;
+  }
   unsaved_changes_ = true;
   return true;
 }
@@ -115,7 +128,9 @@ bool LoafEditor::RemoveItem(const std::string& itemId) {
     return false;
   }
 
-  current_loaf_->RemoveItem(itemId);
+  if (!current_loaf_->RemoveItem(itemId)) {
+    return false;
+  }
   unsaved_changes_ = true;
   return true;
 }
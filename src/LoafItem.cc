@@ -2,18 +2,246 @@
 
 #include <algorithm>
 #include <cctype>
+#include <charconv>
 #include <cstdlib>
-#include <fstream>
 #include <sstream>
+#include <string_view>
+#include <system_error>
 #include <utility>
 
+#ifdef _WIN32
+#include <filesystem>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "OutputCollector.h"
+
 namespace BreadBin {
+namespace {
+#ifndef _WIN32
+#ifdef __APPLE__
+constexpr const char* k_open_command = "open";
+#else
+constexpr const char* k_open_command = "xdg-open";
+#endif
+#endif
+
+enum class PathKind { REGULAR_FILE, ANY };
+
+bool IsReadablePath(const std::string& path, PathKind kind) {
+  if (path.empty()) {
+    return false;
+  }
+#ifdef _WIN32
+  std::error_code error_code;
+  return kind == PathKind::ANY
+             ? std::filesystem::exists(path, error_code)
+             : std::filesystem::is_regular_file(path, error_code);
+#else
+  struct stat status {};
+  if (stat(path.c_str(), &status) != 0) {
+    return false;
+  }
+  if (kind == PathKind::REGULAR_FILE && !S_ISREG(status.st_mode)) {
+    return false;
+  }
+  return faccessat(AT_FDCWD, path.c_str(), R_OK, AT_EACCESS) == 0;
+#endif
+}
+
+bool IsLaunchablePath(const std::string& path) {
+#ifdef __APPLE__
+  struct stat status {};
+  if (path.size() > 4 && path.compare(path.size() - 4, 4, ".app") == 0 &&
+      stat(path.c_str(), &status) == 0 && S_ISDIR(status.st_mode)) {
+    return true;
+  }
+#endif
+  return !ProcessLauncher::FindExecutable(path).empty();
+}
+
+std::vector<std::string> SplitDependencies(const std::string& value) {
+  std::vector<std::string> dependencies;
+  std::istringstream stream(value);
+  std::string token;
+  while (std::getline(stream, token, ',')) {
+    const auto first = token.find_first_not_of(" \t");
+    if (first == std::string::npos) {
+      continue;
+    }
+    const auto last = token.find_last_not_of(" \t");
+    dependencies.push_back(token.substr(first, last - first + 1));
+  }
+  return dependencies;
+}
+
+template <typename T>
+bool ParseNumber(std::string_view text, T* value) {
+  const auto result =
+      std::from_chars(text.data(), text.data() + text.size(), *value);
+  return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+bool ParseCpuList(const std::string& value, std::vector<int>* cpus) {
+  constexpr int k_max_cpu = 1023;
+  for (const auto& token : SplitDependencies(value)) {
+    const std::string_view range(token);
+    const auto dash = range.find('-');
+    int first = 0;
+    int last = 0;
+    if (!ParseNumber(range.substr(0, dash), &first)) {
+      return false;
+    }
+    last = first;
+    if (dash != std::string_view::npos &&
+        !ParseNumber(range.substr(dash + 1), &last)) {
+      return false;
+    }
+    if (first < 0 || last < first || last > k_max_cpu) {
+      return false;
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus->push_back(cpu);
+    }
+  }
+  return !cpus->empty();
+}
+
+bool ParseIoClass(const std::string& value, ResourceLimits* limits) {
+  const auto colon = value.find(':');
+  const std::string name = value.substr(0, colon);
+  if (name == "idle") {
+    limits->io_class = IoClass::IDLE;
+  } else if (name == "best-effort") {
+    limits->io_class = IoClass::BEST_EFFORT;
+  } else if (name == "realtime") {
+    limits->io_class = IoClass::REALTIME;
+  } else {
+    return false;
+  }
+  if (colon == std::string::npos) {
+    return true;
+  }
+  return ParseNumber(std::string_view(value).substr(colon + 1),
+                     &limits->io_priority) &&
+         limits->io_priority >= 0 && limits->io_priority <= 7;
+}
+
+bool ParseByteSize(const std::string& value, uint64_t* bytes) {
+  std::string_view text(value);
+  uint64_t scale = 1;
+  if (!text.empty()) {
+    switch (std::toupper(static_cast<unsigned char>(text.back()))) {
+      case 'K':
+        scale = 1ULL << 10;
+        break;
+      case 'M':
+        scale = 1ULL << 20;
+        break;
+      case 'G':
+        scale = 1ULL << 30;
+        break;
+    }
+    if (scale != 1) {
+      text.remove_suffix(1);
+    }
+  }
+  uint64_t count = 0;
+  if (!ParseNumber(text, &count) || count == 0 || count > UINT64_MAX / scale) {
+    return false;
+  }
+  *bytes = count * scale;
+  return true;
+}
+
+bool ParseOutputCapacity(const LoafItem& item, size_t* capacity,
+                         std::string* error) {
+  const std::string value = item.GetMetadata("output_buffer_size");
+  uint64_t bytes = OutputBuffer::k_default_capacity;
+  if (value == "0") {
+    bytes = 0;
+  } else if (!value.empty() && !ParseByteSize(value, &bytes)) {
+    *error = "Invalid output_buffer_size: " + value;
+    return false;
+  }
+  *capacity = static_cast<size_t>(bytes);
+  return true;
+}
+
+bool ParseResourceLimits(const LoafItem& item, ResourceLimits* limits,
+                         std::string* error) {
+  const std::string affinity = item.GetMetadata("cpu_affinity");
+  if (!affinity.empty() && !ParseCpuList(affinity, &limits->cpu_affinity)) {
+    *error = "Invalid cpu_affinity: " + affinity;
+    return false;
+  }
+
+  const std::string nice = item.GetMetadata("nice");
+  if (!nice.empty()) {
+    limits->set_nice = ParseNumber(std::string_view(nice), &limits->nice) &&
+                       limits->nice >= -20 && limits->nice <= 19;
+    if (!limits->set_nice) {
+      *error = "Invalid nice: " + nice;
+      return false;
+    }
+  }
+
+  const std::string io_class = item.GetMetadata("ionice");
+  if (!io_class.empty() && !ParseIoClass(io_class, limits)) {
+    *error = "Invalid ionice: " + io_class;
+    return false;
+  }
+
+  const std::string address_space = item.GetMetadata("rlimit_as");
+  if (!address_space.empty() &&
+      !ParseByteSize(address_space, &limits->address_space_bytes)) {
+    *error = "Invalid rlimit_as: " + address_space;
+    return false;
+  }
+
+  const std::string open_files = item.GetMetadata("rlimit_nofile");
+  if (!open_files.empty() &&
+      !(ParseNumber(std::string_view(open_files), &limits->open_files) &&
+        limits->open_files > 0)) {
+    *error = "Invalid rlimit_nofile: " + open_files;
+    return false;
+  }
+
+  limits->cgroup = item.GetMetadata("cgroup");
+  return true;
+}
+}  // namespace
 
 LoafItem::LoafItem(std::string id, Type type)
-    : id_(std::move(id)), type_(type), name_(""), path_("") {}
+    : id_(std::move(id)),
+      type_(type),
+      name_(""),
+      path_(""),
+      dependency_revision_(0),
+      last_exit_code_(0) {}
 
 LoafItem::~LoafItem() = default;
 
+std::shared_ptr<LoafItem> LoafItem::Create(Type type, const std::string& id) {
+  switch (type) {
+    case Type::APPLICATION:
+      return std::make_shared<ApplicationItem>(id);
+    case Type::FILE:
+      return std::make_shared<FileItem>(id);
+    case Type::CONFIG:
+      return std::make_shared<ConfigItem>(id);
+    case Type::SCRIPT:
+      return std::make_shared<ScriptItem>(id);
+    case Type::WEBPAGE:
+      return std::make_shared<WebPageItem>(id);
+    default:
+      return nullptr;
+  }
+}
+
 std::string LoafItem::GetId() const { return id_; }
 
 LoafItem::Type LoafItem::GetType() const { return type_; }
@@ -28,6 +256,12 @@ std::string LoafItem::GetPath() const { return path_; }
 
 void LoafItem::SetMetadata(const std::string& key, const std::string& value) {
   metadata_[key] = value;
+  if (key == "args") {
+    arguments_ = ProcessLauncher::SplitArguments(value);
+  } else if (key == "depends_on") {
+    dependencies_ = SplitDependencies(value);
+    ++dependency_revision_;
+  }
 }
 
 std::string LoafItem::GetMetadata(const std::string& key) const {
@@ -35,6 +269,22 @@ std::string LoafItem::GetMetadata(const std::string& key) const {
   return (it != metadata_.end()) ? it->second : "";
 }
 
+const std::map<std::string, std::string>& LoafItem::GetAllMetadata() const {
+  return metadata_;
+}
+
+const std::vector<std::string>& LoafItem::GetArguments() const {
+  return arguments_;
+}
+
+const std::vector<std::string>& LoafItem::GetDependencies() const {
+  return dependencies_;
+}
+
+uint64_t LoafItem::GetDependencyRevision() const {
+  return dependency_revision_;
+}
+
 std::string LoafItem::ToString() const {
   std::ostringstream oss;
   oss << "LoafItem[id=" << id_ << ", name=" << name_ << ", path=" << path_
@@ -42,127 +292,280 @@ std::string LoafItem::ToString() const {
   return oss.str();
 }
 
+bool LoafItem::IsProcessRunning() {
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  int exit_code = 0;
+  if (process_.TryWait(&exit_code)) {
+    last_exit_code_ = exit_code;
+  }
+  return process_.IsValid();
+}
+
+ProcessId LoafItem::GetProcessId() const {
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  return process_.GetProcessId();
+}
+
+int LoafItem::GetPollDescriptor() const {
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  return process_.GetPollDescriptor();
+}
+
+int LoafItem::DuplicatePollDescriptor() const {
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  return process_.DuplicatePollDescriptor();
+}
+
+int LoafItem::GetLastExitCode() const {
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  return last_exit_code_;
+}
+
+std::string LoafItem::GetLastError() const {
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  return last_error_;
+}
+
+void LoafItem::RecordLaunchPhase(LaunchPhase phase,
+                                 LaunchTimeline::Clock::time_point when) {
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  // Restarts after the initial launch must not rewrite its timeline.
+  if (!timeline_.Has(LaunchPhase::READY)) {
+    timeline_.Record(phase, when);
+  }
+}
+
+void LoafItem::ResetLaunchTimeline() {
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  timeline_.Reset();
+  if (output_) {
+    output_->ResetFirstWriteTime();
+  }
+}
+
+LaunchTimeline LoafItem::GetLaunchTimeline() const {
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  LaunchTimeline timeline = timeline_;
+  if (output_ && timeline.Has(LaunchPhase::SPAWN_START) &&
+      !timeline.Has(LaunchPhase::FIRST_OUTPUT)) {
+    if (const auto first_write = output_->GetFirstWriteTime()) {
+      timeline.Record(LaunchPhase::FIRST_OUTPUT, *first_write);
+    }
+  }
+  return timeline;
+}
+
+std::shared_ptr<const OutputBuffer> LoafItem::GetOutput() const {
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  return output_;
+}
+
+bool LoafItem::Fail(const std::string& error) {
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  last_error_ = error;
+  return false;
+}
+
+bool LoafItem::TerminateProcess() {
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  return process_.IsValid() && process_.Terminate();
+}
+
+bool LoafItem::KillProcess() {
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  if (!process_.IsValid()) {
+    return false;
+  }
+  process_.Kill();
+  last_exit_code_ = process_.Wait();
+  return true;
+}
+
+bool LoafItem::Execute() { return Execute(true); }
+
+bool LoafItem::StartProcess(const LaunchOptions& options, bool wait_for_exit) {
+  LaunchOptions spawn_options = options;
+  std::string error;
+  size_t output_capacity = 0;
+  if (!ParseResourceLimits(*this, &spawn_options.limits, &error) ||
+      !ParseOutputCapacity(*this, &output_capacity, &error)) {
+    return Fail(error);
+  }
+
+  // Handler launches hand off to whatever the desktop opens, which outlives
+  // the handler and would inherit the pipe; those keep /dev/null instead.
+  const bool handler_launch = !options.arguments.empty() &&
+                              options.arguments.front() == k_open_command;
+  int output_read = -1;
+  int output_write = -1;
+  if (output_capacity > 0 && !handler_launch &&
+      OutputCollector::IsSupported() &&
+      ProcessLauncher::CreateOutputPipe(&output_read, &output_write)) {
+    spawn_options.output_descriptor = output_write;
+  }
+
+  const auto spawn_start = LaunchTimeline::Clock::now();
+  const ProcessId process_id = ProcessLauncher::Spawn(spawn_options, &error);
+  const auto spawn_done = LaunchTimeline::Clock::now();
+  ProcessLauncher::CloseDescriptor(output_write);
+  if (process_id <= 0) {
+    ProcessLauncher::CloseDescriptor(output_read);
+    return Fail(error);
+  }
+
+  RecordLaunchPhase(LaunchPhase::SPAWN_START, spawn_start);
+  RecordLaunchPhase(LaunchPhase::SPAWN_DONE, spawn_done);
+
+  std::shared_ptr<OutputBuffer> output;
+  {
+    std::lock_guard<std::mutex> lock(process_mutex_);
+    process_.TryWait(nullptr);
+    process_ = ProcessHandle(process_id);
+    last_exit_code_ = 0;
+    last_error_.clear();
+    if (output_read >= 0) {
+      if (!output_ || output_->GetCapacity() != output_capacity) {
+        output_ = std::make_shared<OutputBuffer>(output_capacity);
+      }
+      output = output_;
+    }
+  }
+  if (output) {
+    OutputCollector::Instance().Add(output_read, std::move(output));
+  }
+
+  if (!wait_for_exit) {
+    return true;
+  }
+
+  ProcessLauncher::WaitUntilExited(process_id);
+
+  std::lock_guard<std::mutex> lock(process_mutex_);
+  int exit_code = 0;
+  if (process_.GetProcessId() == process_id && process_.TryWait(&exit_code)) {
+    last_exit_code_ = exit_code;
+  }
+  if (last_exit_code_ != 0) {
+    last_error_ = "Exited with code " + std::to_string(last_exit_code_);
+    return false;
+  }
+  return true;
+}
+
 ApplicationItem::ApplicationItem(const std::string& id)
     : LoafItem(id, Type::APPLICATION) {}
 
-bool ApplicationItem::Execute() {
+bool ApplicationItem::Execute(bool /*wait_for_exit*/) {
   if (path_.empty()) {
-    return false;
+    return Fail("No path set");
   }
 
-  const std::string arguments = GetMetadata("args");
   const std::string working_dir = GetMetadata("working_dir");
 
 #ifdef _WIN32
+  const std::string arguments = GetMetadata("args");
   std::string command = "start \"\" \"" + path_ + "\"";
   if (!arguments.empty()) {
     command += " " + arguments;
   }
   return std::system(command.c_str()) == 0;
-#elif __APPLE__
-  std::string command;
-  if (!working_dir.empty()) {
-    command = "cd \"" + working_dir + "\" && ";
-  }
-  command += "open \"" + path_ + "\"";
-  if (!arguments.empty()) {
-    command += " --args " + arguments;
-  }
-  return std::system(cmd.c_str()) == 0;
 #else
-  std::string command;
-  if (!working_dir.empty()) {
-    command = "cd \"" + working_dir + "\" && ";
+  LaunchOptions options;
+#ifdef __APPLE__
+  options.arguments = {k_open_command, path_};
+  if (!arguments_.empty()) {
+    options.arguments.emplace_back("--args");
   }
-  command += "\"" + path_ + "\"";
-  if (!arguments.empty()) {
-    command += " " + arguments;
-  }
-  command += " >/dev/null 2>&1 &";
-  return std::system(command.c_str()) == 0;
+#else
+  options.arguments = {path_};
+#endif
+  options.arguments.insert(options.arguments.end(), arguments_.begin(),
+                           arguments_.end());
+  options.working_directory = working_dir;
+  options.discard_output = true;
+  return StartProcess(options, false);
 #endif
 }
 
-bool ApplicationItem::Validate() const {
-  std::ifstream file(path_);
-  return file.good();
-}
+bool ApplicationItem::Validate() const { return IsLaunchablePath(path_); }
 
 FileItem::FileItem(const std::string& id) : LoafItem(id, Type::FILE) {}
 
-bool FileItem::Execute() {
+bool FileItem::Execute(bool wait_for_exit) {
   if (path_.empty()) {
-    return false;
+    return Fail("No path set");
   }
 #ifdef _WIN32
   std::string command = "start \"\" \"" + path_ + "\"";
   return std::system(command.c_str()) == 0;
-#elif __APPLE__
-  std::string command = "open \"" + path_ + "\"";
-  return std::system(command.c_str()) == 0;
 #else
-  std::string command = "xdg-open \"" + path_ + "\"";
-  return std::system(command.c_str()) == 0;
+  LaunchOptions options;
+  options.arguments = {k_open_command, path_};
+  return StartProcess(options, wait_for_exit);
 #endif
 }
 
 bool FileItem::Validate() const {
-  std::ifstream file(path_);
-  return file.good();
+  return IsReadablePath(path_, PathKind::ANY);
 }
 
 ConfigItem::ConfigItem(const std::string& id) : LoafItem(id, Type::CONFIG) {}
 
-bool ConfigItem::Execute() { return Validate(); }
+bool ConfigItem::Execute(bool /*wait_for_exit*/) {
+  return Validate() || Fail("Cannot read " + path_);
+}
 
 bool ConfigItem::Validate() const {
-  std::ifstream file(path_);
-  return file.good();
+  return IsReadablePath(path_, PathKind::REGULAR_FILE);
 }
 
 ScriptItem::ScriptItem(const std::string& id) : LoafItem(id, Type::SCRIPT) {}
 
-bool ScriptItem::Execute() {
+bool ScriptItem::Execute(bool wait_for_exit) {
   if (path_.empty()) {
-    return false;
+    return Fail("No path set");
   }
+#ifdef _WIN32
   std::string command = "\"" + path_ + "\"";
   return std::system(command.c_str()) == 0;
+#else
+  LaunchOptions options;
+  options.arguments = {path_};
+  options.arguments.insert(options.arguments.end(), arguments_.begin(),
+                           arguments_.end());
+  options.working_directory = GetMetadata("working_dir");
+  return StartProcess(options, wait_for_exit);
+#endif
 }
 
-bool ScriptItem::Validate() const {
-  std::ifstream file(path_);
-  return file.good();
-}
+bool ScriptItem::Validate() const { return IsLaunchablePath(path_); }
 
 WebPageItem::WebPageItem(const std::string& id) : LoafItem(id, Type::WEBPAGE) {}
 
-bool WebPageItem::Execute() {
+bool WebPageItem::Execute(bool wait_for_exit) {
   if (path_.empty()) {
-    return false;
+    return Fail("No path set");
   }
 
   if (!Validate()) {
-    return false;
+    return Fail("Not an http(s) URL");
   }
 
   for (char c : path_) {
     if (!isalnum(c) && c != ':' && c != '/' && c != '.' && c != '-' &&
         c != '_' && c != '?' && c != '=' && c != '&' && c != '#' && c != '%' &&
         c != '+') {
-      return false;
+      return Fail(std::string("Unsupported character in URL: ") + c);
     }
   }
 
 #ifdef _WIN32
   std::string command = "rundll32 url.dll,FileProtocolHandler " + path_;
   return std::system(command.c_str()) == 0;
-#elif __APPLE__
-  std::string command = "open " + path_;
-  return std::system(command.c_str()) == 0;
 #else
-  std::string command = "xdg-open " + path_;
-  return std::system(command.c_str()) == 0;
+  LaunchOptions options;
+  options.arguments = {k_open_command, path_};
+  return StartProcess(options, wait_for_exit);
 #endif
 }
 
@@ -0,0 +1,199 @@
+#include "LoafTextParser.h"
+
+#include <charconv>
+#include <utility>
+
+#include "Loaf.h"
+
+namespace BreadBin {
+namespace {
+bool ParseType(std::string_view text, LoafItem::Type* type) {
+  if (text == "APPLICATION") {
+    *type = LoafItem::Type::APPLICATION;
+  } else if (text == "FILE") {
+    *type = LoafItem::Type::FILE;
+  } else if (text == "CONFIG") {
+    *type = LoafItem::Type::CONFIG;
+  } else if (text == "SCRIPT") {
+    *type = LoafItem::Type::SCRIPT;
+  } else if (text == "WEBPAGE") {
+    *type = LoafItem::Type::WEBPAGE;
+  } else {
+    return false;
+  }
+  return true;
+}
+}  // namespace
+
+std::string LoafParseError::ToString() const {
+  return std::to_string(line) + ":" + std::to_string(column) + ": " + message;
+}
+
+LoafTextParser::LoafTextParser(std::string_view data)
+    : data_(data), position_(0), line_number_(0) {}
+
+const LoafParseError& LoafTextParser::GetError() const { return error_; }
+
+bool LoafTextParser::Parse(Loaf* loaf) {
+  LoafSummary summary;
+  if (!ParseHeader(&summary, loaf)) {
+    return false;
+  }
+  for (size_t i = 0; i < summary.item_count; ++i) {
+    if (!ParseItem(loaf)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool LoafTextParser::ParseSummary(LoafSummary* summary) {
+  return ParseHeader(summary, nullptr);
+}
+
+bool LoafTextParser::NextLine(std::string_view* line) {
+  if (position_ >= data_.size()) {
+    return false;
+  }
+
+  size_t end = data_.find('\n', position_);
+  if (end == std::string_view::npos) {
+    end = data_.size();
+  }
+  *line = data_.substr(position_, end - position_);
+  if (!line->empty() && line->back() == '\r') {
+    line->remove_suffix(1);
+  }
+  position_ = end + 1;
+  ++line_number_;
+  return true;
+}
+
+bool LoafTextParser::ExpectField(std::string_view prefix,
+                                 std::string_view* value) {
+  std::string_view line;
+  if (!NextLine(&line)) {
+    ++line_number_;
+    return Fail(1, "unexpected end of file, expected '" +
+                       std::string(prefix) + "'");
+  }
+  if (line.substr(0, prefix.size()) != prefix) {
+    return Fail(1, "expected '" + std::string(prefix) + "'");
+  }
+  *value = line.substr(prefix.size());
+  return true;
+}
+
+bool LoafTextParser::ParseCount(std::string_view text, size_t column,
+                                size_t* count) {
+  const char* end = text.data() + text.size();
+  auto [ptr, ec] = std::from_chars(text.data(), end, *count);
+  if (ec != std::errc() || ptr != end) {
+    return Fail(column, "expected a non-negative count");
+  }
+  return true;
+}
+
+bool LoafTextParser::ParseHeader(LoafSummary* summary, Loaf* loaf) {
+  std::string_view name;
+  std::string_view description;
+  std::string_view layout;
+  NextLine(&name);
+  NextLine(&description);
+  NextLine(&layout);
+  summary->name = std::string(name);
+  summary->description = std::string(description);
+  summary->layout = std::string(layout);
+  summary->item_count = 0;
+  if (loaf) {
+    loaf->SetName(summary->name);
+    loaf->SetDescription(summary->description);
+    loaf->SetLayout(summary->layout);
+  }
+
+  std::string_view line;
+  if (!NextLine(&line)) {
+    return true;
+  }
+  size_t rule_count = 0;
+  if (!ParseCount(line, 1, &rule_count)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < rule_count; ++i) {
+    std::string_view key;
+    std::string_view value;
+    if (!NextLine(&key) || !NextLine(&value)) {
+      ++line_number_;
+      return Fail(1, "unexpected end of file in runtime rules");
+    }
+    if (loaf) {
+      loaf->SetRuntimeRule(std::string(key), std::string(value));
+    }
+  }
+
+  if (!NextLine(&line)) {
+    return true;
+  }
+  return ParseCount(line, 1, &summary->item_count);
+}
+
+bool LoafTextParser::ParseItem(Loaf* loaf) {
+  std::string_view type_text;
+  std::string_view id;
+  std::string_view name;
+  std::string_view path;
+  std::string_view meta_count_text;
+  LoafItem::Type type = LoafItem::Type::APPLICATION;
+
+  if (!ExpectField("TYPE:", &type_text)) {
+    return false;
+  }
+  if (!ParseType(type_text, &type)) {
+    return Fail(6, "unknown item type '" + std::string(type_text) + "'");
+  }
+  if (!ExpectField("ID:", &id)) {
+    return false;
+  }
+  if (loaf->HasItem(std::string(id))) {
+    return Fail(4, "duplicate item id '" + std::string(id) + "'");
+  }
+  if (!ExpectField("NAME:", &name) ||
+      !ExpectField("PATH:", &path) ||
+      !ExpectField("META_COUNT:", &meta_count_text)) {
+    return false;
+  }
+  size_t meta_count = 0;
+  if (!ParseCount(meta_count_text, 12, &meta_count)) {
+    return false;
+  }
+
+  auto item = LoafItem::Create(type, std::string(id));
+  item->SetName(std::string(name));
+  item->SetPath(std::string(path));
+  for (size_t m = 0; m < meta_count; ++m) {
+    std::string_view key;
+    std::string_view value;
+    if (!ExpectField("META_KEY:", &key) ||
+        !ExpectField("META_VALUE:", &value)) {
+      return false;
+    }
+    item->SetMetadata(std::string(key), std::string(value));
+  }
+
+  std::string_view end_marker;
+  if (!ExpectField("END_ITEM", &end_marker)) {
+    return false;
+  }
+  loaf->AddItem(std::move(item));
+  return true;
+}
+
+bool LoafTextParser::Fail(size_t column, std::string message) {
+  error_.line = line_number_;
+  error_.column = column;
+  error_.message = std::move(message);
+  return false;
+}
+
+}  // namespace BreadBin
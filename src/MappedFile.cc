@@ -0,0 +1,92 @@
+#include "MappedFile.h"
+
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BreadBin {
+MappedFile::MappedFile()
+    : data_(nullptr), size_(0), open_(false), mapped_(false) {}
+
+MappedFile::~MappedFile() { Close(); }
+
+bool MappedFile::IsOpen() const { return open_; }
+
+std::string_view MappedFile::GetData() const {
+  return std::string_view(data_, size_);
+}
+
+#ifdef _WIN32
+bool MappedFile::Open(const std::string& filepath) {
+  Close();
+  std::ifstream file(filepath, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+  buffer_.assign(std::istreambuf_iterator<char>(file),
+                 std::istreambuf_iterator<char>());
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+  open_ = true;
+  return true;
+}
+
+void MappedFile::Close() {
+  buffer_.clear();
+  data_ = nullptr;
+  size_ = 0;
+  open_ = false;
+  mapped_ = false;
+}
+#else
+bool MappedFile::Open(const std::string& filepath) {
+  Close();
+  const int descriptor = open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (descriptor < 0) {
+    return false;
+  }
+
+  struct stat info {};
+  if (fstat(descriptor, &info) != 0 || !S_ISREG(info.st_mode)) {
+    close(descriptor);
+    return false;
+  }
+
+  size_ = static_cast<size_t>(info.st_size);
+  if (size_ > 0) {
+    void* address =
+        mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (address == MAP_FAILED) {
+      close(descriptor);
+      size_ = 0;
+      return false;
+    }
+    madvise(address, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(address);
+    mapped_ = true;
+  }
+
+  close(descriptor);
+  open_ = true;
+  return true;
+}
+
+void MappedFile::Close() {
+  if (mapped_) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+  buffer_.clear();
+  data_ = nullptr;
+  size_ = 0;
+  open_ = false;
+  mapped_ = false;
+}
+#endif
+
+}  // namespace BreadBin
@@ -0,0 +1,71 @@
+#include "OutputBuffer.h"
+
+#include <algorithm>
+
+namespace BreadBin {
+OutputBuffer::OutputBuffer(size_t capacity)
+    : storage_(std::max<size_t>(capacity, 1)), total_written_(0) {}
+
+void OutputBuffer::Append(std::string_view data) {
+  if (data.empty()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!first_write_) {
+    first_write_ = Clock::now();
+  }
+
+  const size_t capacity = storage_.size();
+  if (data.size() > capacity) {
+    total_written_ += data.size() - capacity;
+    data.remove_prefix(data.size() - capacity);
+  }
+
+  size_t offset = static_cast<size_t>(total_written_ % capacity);
+  const size_t first = std::min(data.size(), capacity - offset);
+  std::copy_n(data.data(), first, storage_.data() + offset);
+  std::copy_n(data.data() + first, data.size() - first, storage_.data());
+  total_written_ += data.size();
+}
+
+std::string OutputBuffer::ReadSince(uint64_t position,
+                                    uint64_t* next_position) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const size_t capacity = storage_.size();
+  const uint64_t oldest =
+      total_written_ > capacity ? total_written_ - capacity : 0;
+  position = std::clamp(position, oldest, total_written_);
+  if (next_position) {
+    *next_position = total_written_;
+  }
+
+  std::string result(static_cast<size_t>(total_written_ - position), '\0');
+  const size_t offset = static_cast<size_t>(position % capacity);
+  const size_t first = std::min(result.size(), capacity - offset);
+  std::copy_n(storage_.data() + offset, first, result.data());
+  std::copy_n(storage_.data(), result.size() - first, result.data() + first);
+  return result;
+}
+
+std::string OutputBuffer::ReadAll() const { return ReadSince(0, nullptr); }
+
+uint64_t OutputBuffer::GetTotalWritten() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return total_written_;
+}
+
+size_t OutputBuffer::GetCapacity() const { return storage_.size(); }
+
+std::optional<OutputBuffer::Clock::time_point>
+OutputBuffer::GetFirstWriteTime() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return first_write_;
+}
+
+void OutputBuffer::ResetFirstWriteTime() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  first_write_.reset();
+}
+
+}  // namespace BreadBin
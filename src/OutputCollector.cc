@@ -0,0 +1,186 @@
+#include "OutputCollector.h"
+
+#include <cerrno>
+#include <utility>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+namespace BreadBin {
+namespace {
+constexpr size_t k_read_size = 16 * 1024;
+constexpr int k_max_events = 32;
+// Reads per wakeup, so one chatty process cannot starve the others. The
+// epoll set is level-triggered, so anything left over wakes the loop again.
+constexpr int k_max_reads_per_wakeup = 4;
+}  // namespace
+
+OutputCollector& OutputCollector::Instance() {
+  static OutputCollector collector;
+  return collector;
+}
+
+OutputCollector::OutputCollector()
+    : epoll_descriptor_(-1), wake_descriptor_(-1), stopping_(false) {}
+
+#ifdef __linux__
+bool OutputCollector::IsSupported() { return true; }
+
+OutputCollector::~OutputCollector() {
+  if (thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    const uint64_t value = 1;
+    [[maybe_unused]] const ssize_t written =
+        write(wake_descriptor_, &value, sizeof(value));
+    thread_.join();
+  }
+
+  for (const auto& [descriptor, buffer] : sources_) {
+    close(descriptor);
+  }
+  if (wake_descriptor_ >= 0) {
+    close(wake_descriptor_);
+  }
+  if (epoll_descriptor_ >= 0) {
+    close(epoll_descriptor_);
+  }
+}
+
+bool OutputCollector::Start() {
+  if (thread_.joinable()) {
+    return true;
+  }
+
+  if (epoll_descriptor_ < 0) {
+    epoll_descriptor_ = epoll_create1(EPOLL_CLOEXEC);
+  }
+  if (wake_descriptor_ < 0) {
+    wake_descriptor_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_descriptor_ >= 0 && epoll_descriptor_ >= 0) {
+      epoll_event event{};
+      event.events = EPOLLIN;
+      event.data.fd = wake_descriptor_;
+      epoll_ctl(epoll_descriptor_, EPOLL_CTL_ADD, wake_descriptor_, &event);
+    }
+  }
+  if (epoll_descriptor_ < 0 || wake_descriptor_ < 0) {
+    return false;
+  }
+
+  thread_ = std::thread(&OutputCollector::Loop, this);
+  return true;
+}
+
+bool OutputCollector::Add(int descriptor, std::shared_ptr<OutputBuffer> buffer) {
+  if (descriptor < 0 || !buffer) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!Start()) {
+    close(descriptor);
+    return false;
+  }
+
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.fd = descriptor;
+  if (epoll_ctl(epoll_descriptor_, EPOLL_CTL_ADD, descriptor, &event) != 0) {
+    close(descriptor);
+    return false;
+  }
+  sources_[descriptor] = std::move(buffer);
+  return true;
+}
+
+void OutputCollector::Remove(int descriptor) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  epoll_ctl(epoll_descriptor_, EPOLL_CTL_DEL, descriptor, nullptr);
+  close(descriptor);
+  sources_.erase(descriptor);
+}
+
+bool OutputCollector::Drain(int descriptor, OutputBuffer& buffer) {
+  char data[k_read_size];
+  int reads = 0;
+  while (reads < k_max_reads_per_wakeup) {
+    const ssize_t count = read(descriptor, data, sizeof(data));
+    if (count > 0) {
+      buffer.Append(std::string_view(data, static_cast<size_t>(count)));
+      ++reads;
+      continue;
+    }
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    return count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+  }
+  return true;
+}
+
+void OutputCollector::Loop() {
+  epoll_event events[k_max_events];
+  while (true) {
+    const int count = epoll_wait(epoll_descriptor_, events, k_max_events, -1);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+
+    for (int i = 0; i < count; ++i) {
+      const int descriptor = events[i].data.fd;
+      if (descriptor == wake_descriptor_) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+          return;
+        }
+        continue;
+      }
+
+      std::shared_ptr<OutputBuffer> buffer;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sources_.find(descriptor);
+        if (it == sources_.end()) {
+          continue;
+        }
+        buffer = it->second;
+      }
+      if (!Drain(descriptor, *buffer)) {
+        Remove(descriptor);
+      }
+    }
+  }
+}
+#else
+bool OutputCollector::IsSupported() { return false; }
+
+OutputCollector::~OutputCollector() {}
+
+bool OutputCollector::Start() { return false; }
+
+bool OutputCollector::Add(int descriptor, std::shared_ptr<OutputBuffer> buffer) {
+  return false;
+}
+
+void OutputCollector::Remove(int descriptor) {}
+
+bool OutputCollector::Drain(int descriptor, OutputBuffer& buffer) {
+  return false;
+}
+
+void OutputCollector::Loop() {}
+#endif
+
+}  // namespace BreadBin
@@ -0,0 +1,617 @@
+#include "ProcessLauncher.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#ifdef _WIN32
+#include <filesystem>
+#else
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+#ifndef _WIN32
+extern char** environ;
+#endif
+
+namespace BreadBin {
+namespace {
+#ifndef _WIN32
+int DecodeWaitStatus(int status) {
+  if (WIFEXITED(status)) {
+    return WEXITSTATUS(status);
+  }
+  if (WIFSIGNALED(status)) {
+    return 128 + WTERMSIG(status);
+  }
+  return -1;
+}
+
+bool SignalProcessGroup(ProcessId process_id, int signal) {
+  if (process_id <= 0) {
+    return false;
+  }
+  if (kill(-static_cast<pid_t>(process_id), signal) == 0) {
+    return true;
+  }
+  return kill(static_cast<pid_t>(process_id), signal) == 0;
+}
+#endif
+
+int OpenPollDescriptor(ProcessId process_id) {
+#if defined(__linux__) && defined(SYS_pidfd_open)
+  if (process_id > 0) {
+    const long descriptor =
+        syscall(SYS_pidfd_open, static_cast<pid_t>(process_id), 0);
+    if (descriptor >= 0) {
+      fcntl(static_cast<int>(descriptor), F_SETFD, FD_CLOEXEC);
+      return static_cast<int>(descriptor);
+    }
+  }
+#endif
+  return -1;
+}
+
+#ifndef _WIN32
+enum class SpawnStage : int {
+  CHDIR,
+  OUTPUT,
+  CGROUP,
+  AFFINITY,
+  NICE,
+  IO_PRIORITY,
+  ADDRESS_SPACE,
+  OPEN_FILES,
+  EXEC
+};
+
+struct SpawnFailure {
+  SpawnStage stage;
+  int error;
+};
+
+const char* DescribeStage(SpawnStage stage) {
+  switch (stage) {
+    case SpawnStage::CHDIR:
+      return "cannot change directory";
+    case SpawnStage::OUTPUT:
+      return "cannot redirect output";
+    case SpawnStage::CGROUP:
+      return "cannot join cgroup";
+    case SpawnStage::AFFINITY:
+      return "cannot set CPU affinity";
+    case SpawnStage::NICE:
+      return "cannot set nice value";
+    case SpawnStage::IO_PRIORITY:
+      return "cannot set I/O priority";
+    case SpawnStage::ADDRESS_SPACE:
+      return "cannot limit address space";
+    case SpawnStage::OPEN_FILES:
+      return "cannot limit open files";
+    default:
+      return "cannot execute";
+  }
+}
+
+bool OpenCloexecPipe(int descriptors[2]) {
+#ifdef __linux__
+  return pipe2(descriptors, O_CLOEXEC) == 0;
+#else
+  if (pipe(descriptors) != 0) {
+    return false;
+  }
+  fcntl(descriptors[0], F_SETFD, FD_CLOEXEC);
+  fcntl(descriptors[1], F_SETFD, FD_CLOEXEC);
+  return true;
+#endif
+}
+
+[[noreturn]] void FailChild(int report_descriptor, SpawnStage stage) {
+  const SpawnFailure failure{stage, errno};
+  [[maybe_unused]] const ssize_t written =
+      write(report_descriptor, &failure, sizeof(failure));
+  _exit(127);
+}
+
+// Runs between fork and exec, so only async-signal-safe calls are allowed.
+[[noreturn]] void RunChild(const LaunchOptions& options,
+                           const std::string& executable, char* const* argv,
+                           const std::string& cgroup_procs,
+                           int report_descriptor) {
+  const ResourceLimits& limits = options.limits;
+  setpgid(0, 0);
+
+  sigset_t empty_mask;
+  sigemptyset(&empty_mask);
+  sigprocmask(SIG_SETMASK, &empty_mask, nullptr);
+  signal(SIGPIPE, SIG_DFL);
+  signal(SIGCHLD, SIG_DFL);
+
+  if (!options.working_directory.empty() &&
+      chdir(options.working_directory.c_str()) != 0) {
+    FailChild(report_descriptor, SpawnStage::CHDIR);
+  }
+  if (options.output_descriptor >= 0) {
+    if (dup2(options.output_descriptor, STDOUT_FILENO) < 0 ||
+        dup2(options.output_descriptor, STDERR_FILENO) < 0) {
+      FailChild(report_descriptor, SpawnStage::OUTPUT);
+    }
+  } else if (options.discard_output) {
+    const int null_descriptor = open("/dev/null", O_WRONLY);
+    if (null_descriptor < 0 || dup2(null_descriptor, STDOUT_FILENO) < 0 ||
+        dup2(null_descriptor, STDERR_FILENO) < 0) {
+      FailChild(report_descriptor, SpawnStage::OUTPUT);
+    }
+    close(null_descriptor);
+  }
+
+  if (!cgroup_procs.empty()) {
+    const int descriptor = open(cgroup_procs.c_str(), O_WRONLY);
+    if (descriptor < 0 || write(descriptor, "0", 1) != 1) {
+      FailChild(report_descriptor, SpawnStage::CGROUP);
+    }
+    close(descriptor);
+  }
+
+#ifdef __linux__
+  if (!limits.cpu_affinity.empty()) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu : limits.cpu_affinity) {
+      CPU_SET(cpu, &cpus);
+    }
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+      FailChild(report_descriptor, SpawnStage::AFFINITY);
+    }
+  }
+#ifdef SYS_ioprio_set
+  if (limits.io_class != IoClass::INHERIT) {
+    constexpr int k_io_priority_who_process = 1;
+    constexpr int k_io_priority_class_shift = 13;
+    const int value =
+        (static_cast<int>(limits.io_class) << k_io_priority_class_shift) |
+        limits.io_priority;
+    if (syscall(SYS_ioprio_set, k_io_priority_who_process, 0, value) != 0) {
+      FailChild(report_descriptor, SpawnStage::IO_PRIORITY);
+    }
+  }
+#endif
+#endif
+
+  if (limits.set_nice && setpriority(PRIO_PROCESS, 0, limits.nice) != 0) {
+    FailChild(report_descriptor, SpawnStage::NICE);
+  }
+  if (limits.address_space_bytes > 0) {
+    const rlimit limit{static_cast<rlim_t>(limits.address_space_bytes),
+                       static_cast<rlim_t>(limits.address_space_bytes)};
+    if (setrlimit(RLIMIT_AS, &limit) != 0) {
+      FailChild(report_descriptor, SpawnStage::ADDRESS_SPACE);
+    }
+  }
+  if (limits.open_files > 0) {
+    const rlimit limit{static_cast<rlim_t>(limits.open_files),
+                       static_cast<rlim_t>(limits.open_files)};
+    if (setrlimit(RLIMIT_NOFILE, &limit) != 0) {
+      FailChild(report_descriptor, SpawnStage::OPEN_FILES);
+    }
+  }
+
+  execv(executable.c_str(), argv);
+  FailChild(report_descriptor, SpawnStage::EXEC);
+}
+
+ProcessId SpawnWithLimits(const LaunchOptions& options, char* const* argv,
+                          std::string* error) {
+  std::string executable =
+      ProcessLauncher::FindExecutable(options.arguments.front());
+  if (executable.empty()) {
+    executable = options.arguments.front();
+  }
+  std::string cgroup_procs;
+  if (!options.limits.cgroup.empty()) {
+    cgroup_procs = options.limits.cgroup.front() == '/'
+                       ? options.limits.cgroup
+                       : "/sys/fs/cgroup/" + options.limits.cgroup;
+    cgroup_procs += "/cgroup.procs";
+  }
+
+  int report[2];
+  if (!OpenCloexecPipe(report)) {
+    if (error) {
+      *error = options.arguments.front() + ": " + std::strerror(errno);
+    }
+    return -1;
+  }
+
+  const pid_t process_id = fork();
+  if (process_id == 0) {
+    close(report[0]);
+    RunChild(options, executable, argv, cgroup_procs, report[1]);
+  }
+  close(report[1]);
+  if (process_id < 0) {
+    const int fork_error = errno;
+    close(report[0]);
+    if (error) {
+      *error = options.arguments.front() + ": " + std::strerror(fork_error);
+    }
+    return -1;
+  }
+
+  SpawnFailure failure{};
+  ssize_t received = 0;
+  do {
+    received = read(report[0], &failure, sizeof(failure));
+  } while (received < 0 && errno == EINTR);
+  close(report[0]);
+
+  if (received == static_cast<ssize_t>(sizeof(failure))) {
+    ProcessLauncher::WaitForExit(process_id);
+    if (error) {
+      *error = options.arguments.front() + ": " +
+               DescribeStage(failure.stage) + ": " +
+               std::strerror(failure.error);
+    }
+    return -1;
+  }
+  return process_id;
+}
+#endif
+}  // namespace
+
+bool ResourceLimits::IsEmpty() const {
+  return cpu_affinity.empty() && !set_nice && io_class == IoClass::INHERIT &&
+         address_space_bytes == 0 && open_files == 0 && cgroup.empty();
+}
+
+ProcessHandle::ProcessHandle() : process_id_(-1), poll_descriptor_(-1) {}
+
+ProcessHandle::ProcessHandle(ProcessId process_id)
+    : process_id_(process_id),
+      poll_descriptor_(OpenPollDescriptor(process_id)) {}
+
+ProcessHandle::~ProcessHandle() { Reset(); }
+
+ProcessHandle::ProcessHandle(ProcessHandle&& other) noexcept
+    : process_id_(std::exchange(other.process_id_, -1)),
+      poll_descriptor_(std::exchange(other.poll_descriptor_, -1)) {}
+
+ProcessHandle& ProcessHandle::operator=(ProcessHandle&& other) noexcept {
+  if (this != &other) {
+    Reset();
+    process_id_ = std::exchange(other.process_id_, -1);
+    poll_descriptor_ = std::exchange(other.poll_descriptor_, -1);
+  }
+  return *this;
+}
+
+bool ProcessHandle::IsValid() const { return process_id_ > 0; }
+
+ProcessId ProcessHandle::GetProcessId() const { return process_id_; }
+
+int ProcessHandle::GetPollDescriptor() const { return poll_descriptor_; }
+
+int ProcessHandle::DuplicatePollDescriptor() const {
+#ifndef _WIN32
+  if (poll_descriptor_ >= 0) {
+    return fcntl(poll_descriptor_, F_DUPFD_CLOEXEC, 0);
+  }
+#endif
+  return -1;
+}
+
+void ProcessHandle::Reset() {
+#ifndef _WIN32
+  if (poll_descriptor_ >= 0) {
+    close(poll_descriptor_);
+  }
+#endif
+  poll_descriptor_ = -1;
+  process_id_ = -1;
+}
+
+#ifdef _WIN32
+bool ProcessHandle::Terminate() const { return false; }
+
+bool ProcessHandle::Kill() const { return false; }
+
+bool ProcessHandle::TryWait(int* exit_code) { return false; }
+
+int ProcessHandle::Wait() { return -1; }
+#else
+bool ProcessHandle::Terminate() const {
+  return SignalProcessGroup(process_id_, SIGTERM);
+}
+
+bool ProcessHandle::Kill() const {
+  return SignalProcessGroup(process_id_, SIGKILL);
+}
+
+bool ProcessHandle::TryWait(int* exit_code) {
+  if (!IsValid()) {
+    return false;
+  }
+
+  int status = 0;
+  pid_t result = 0;
+  do {
+    result = waitpid(static_cast<pid_t>(process_id_), &status, WNOHANG);
+  } while (result < 0 && errno == EINTR);
+
+  if (result == 0) {
+    return false;
+  }
+  if (exit_code) {
+    *exit_code = result > 0 ? DecodeWaitStatus(status) : -1;
+  }
+  Reset();
+  return true;
+}
+
+int ProcessHandle::Wait() {
+  if (!IsValid()) {
+    return -1;
+  }
+  const int exit_code = ProcessLauncher::WaitForExit(process_id_);
+  Reset();
+  return exit_code;
+}
+#endif
+
+bool ProcessLauncher::IsExecutableFile(const std::string& path) {
+#ifdef _WIN32
+  std::error_code error_code;
+  return std::filesystem::is_regular_file(path, error_code);
+#else
+  struct stat status {};
+  return stat(path.c_str(), &status) == 0 && S_ISREG(status.st_mode) &&
+         faccessat(AT_FDCWD, path.c_str(), X_OK, AT_EACCESS) == 0;
+#endif
+}
+
+std::string ProcessLauncher::FindExecutable(const std::string& name) {
+  if (name.empty()) {
+    return {};
+  }
+  if (name.find('/') != std::string::npos) {
+    return IsExecutableFile(name) ? name : std::string();
+  }
+#ifdef _WIN32
+  return IsExecutableFile(name) ? name : std::string();
+#else
+  const char* path = std::getenv("PATH");
+  std::string directories = path ? path : "/usr/local/bin:/usr/bin:/bin";
+  size_t start = 0;
+  while (start <= directories.size()) {
+    size_t end = directories.find(':', start);
+    if (end == std::string::npos) {
+      end = directories.size();
+    }
+    std::string candidate = directories.substr(start, end - start);
+    candidate = (candidate.empty() ? "." : candidate) + "/" + name;
+    if (IsExecutableFile(candidate)) {
+      return candidate;
+    }
+    start = end + 1;
+  }
+  return {};
+#endif
+}
+
+std::vector<std::string> ProcessLauncher::SplitArguments(
+    const std::string& arguments) {
+  std::vector<std::string> result;
+  std::string current;
+  bool in_token = false;
+  char quote = '\0';
+
+  for (size_t i = 0; i < arguments.size(); ++i) {
+    const char c = arguments[i];
+
+    if (quote == '\'') {
+      if (c == '\'') {
+        quote = '\0';
+      } else {
+        current += c;
+      }
+      continue;
+    }
+
+    if (c == '\\' && i + 1 < arguments.size() &&
+        (quote == '\0' || arguments[i + 1] == '"' ||
+         arguments[i + 1] == '\\')) {
+      current += arguments[++i];
+      in_token = true;
+      continue;
+    }
+
+    if (quote == '"') {
+      if (c == '"') {
+        quote = '\0';
+      } else {
+        current += c;
+      }
+      continue;
+    }
+
+    if (c == '\'' || c == '"') {
+      quote = c;
+      in_token = true;
+    } else if (c == ' ' || c == '\t' || c == '\n') {
+      if (in_token) {
+        result.push_back(current);
+        current.clear();
+        in_token = false;
+      }
+    } else {
+      current += c;
+      in_token = true;
+    }
+  }
+
+  if (in_token) {
+    result.push_back(current);
+  }
+  return result;
+}
+
+#ifdef _WIN32
+ProcessId ProcessLauncher::Spawn(const LaunchOptions& options,
+                                 std::string* error) {
+  if (error) {
+    *error = "Native process spawning is not supported on this platform";
+  }
+  return -1;
+}
+
+bool ProcessLauncher::CreateOutputPipe(int* read_descriptor,
+                                       int* write_descriptor) {
+  return false;
+}
+
+void ProcessLauncher::CloseDescriptor(int descriptor) {}
+
+int ProcessLauncher::WaitForExit(ProcessId process_id) { return -1; }
+
+void ProcessLauncher::WaitUntilExited(ProcessId process_id) {}
+#else
+ProcessId ProcessLauncher::Spawn(const LaunchOptions& options,
+                                 std::string* error) {
+  if (options.arguments.empty() || options.arguments.front().empty()) {
+    if (error) {
+      *error = "No executable given";
+    }
+    return -1;
+  }
+
+  std::vector<char*> argv;
+  argv.reserve(options.arguments.size() + 1);
+  for (const auto& argument : options.arguments) {
+    argv.push_back(const_cast<char*>(argument.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  if (!options.limits.IsEmpty()) {
+    return SpawnWithLimits(options, argv.data(), error);
+  }
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawnattr_t attributes;
+  posix_spawnattr_init(&attributes);
+
+  int result = 0;
+  if (!options.working_directory.empty()) {
+    result = posix_spawn_file_actions_addchdir_np(
+        &actions, options.working_directory.c_str());
+  }
+  if (result == 0 && options.output_descriptor >= 0) {
+    result = posix_spawn_file_actions_adddup2(
+        &actions, options.output_descriptor, STDOUT_FILENO);
+    if (result == 0) {
+      result = posix_spawn_file_actions_adddup2(
+          &actions, options.output_descriptor, STDERR_FILENO);
+    }
+  } else if (result == 0 && options.discard_output) {
+    result = posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO,
+                                              "/dev/null", O_WRONLY, 0);
+    if (result == 0) {
+      result =
+          posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+    }
+  }
+
+  sigset_t empty_mask;
+  sigemptyset(&empty_mask);
+  sigset_t default_signals;
+  sigemptyset(&default_signals);
+  sigaddset(&default_signals, SIGPIPE);
+  sigaddset(&default_signals, SIGCHLD);
+  if (result == 0) {
+    posix_spawnattr_setsigmask(&attributes, &empty_mask);
+    posix_spawnattr_setsigdefault(&attributes, &default_signals);
+    posix_spawnattr_setpgroup(&attributes, 0);
+    result = posix_spawnattr_setflags(
+        &attributes, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF |
+                         POSIX_SPAWN_SETPGROUP);
+  }
+
+  pid_t process_id = -1;
+  if (result == 0) {
+    result = posix_spawnp(&process_id, argv.front(), &actions, &attributes,
+                          argv.data(), environ);
+  }
+
+  posix_spawnattr_destroy(&attributes);
+  posix_spawn_file_actions_destroy(&actions);
+
+  if (result != 0) {
+    if (error) {
+      *error = options.arguments.front() + ": " + std::strerror(result);
+    }
+    return -1;
+  }
+  return process_id;
+}
+
+bool ProcessLauncher::CreateOutputPipe(int* read_descriptor,
+                                       int* write_descriptor) {
+  int descriptors[2];
+  if (!OpenCloexecPipe(descriptors)) {
+    return false;
+  }
+  fcntl(descriptors[0], F_SETFL, fcntl(descriptors[0], F_GETFL) | O_NONBLOCK);
+  *read_descriptor = descriptors[0];
+  *write_descriptor = descriptors[1];
+  return true;
+}
+
+void ProcessLauncher::CloseDescriptor(int descriptor) {
+  if (descriptor >= 0) {
+    close(descriptor);
+  }
+}
+
+int ProcessLauncher::WaitForExit(ProcessId process_id) {
+  if (process_id <= 0) {
+    return -1;
+  }
+
+  int status = 0;
+  while (waitpid(static_cast<pid_t>(process_id), &status, 0) < 0) {
+    if (errno != EINTR) {
+      return -1;
+    }
+  }
+  return DecodeWaitStatus(status);
+}
+
+void ProcessLauncher::WaitUntilExited(ProcessId process_id) {
+  if (process_id <= 0) {
+    return;
+  }
+
+  siginfo_t info;
+  while (waitid(P_PID, static_cast<id_t>(process_id), &info,
+                WEXITED | WNOWAIT) < 0) {
+    if (errno != EINTR) {
+      return;
+    }
+  }
+}
+#endif
+
+}  // namespace BreadBin
\ No newline at end of file
@@ -0,0 +1,260 @@
+#include "ProcessMonitor.h"
+
+#include <cerrno>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+namespace BreadBin {
+namespace {
+constexpr uint64_t k_wake_key = 0;
+constexpr int k_max_events = 32;
+}  // namespace
+
+ProcessMonitor::ProcessMonitor(Callback callback)
+    : callback_(std::move(callback)),
+      next_key_(k_wake_key + 1),
+      epoll_descriptor_(-1),
+      wake_descriptor_(-1),
+      stopping_(false) {}
+
+ProcessMonitor::~ProcessMonitor() { Stop(); }
+
+bool ProcessMonitor::IsActive() const { return thread_.joinable(); }
+
+#ifdef __linux__
+bool ProcessMonitor::Start() {
+  if (IsActive()) {
+    return true;
+  }
+
+  epoll_descriptor_ = epoll_create1(EPOLL_CLOEXEC);
+  wake_descriptor_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (epoll_descriptor_ < 0 || wake_descriptor_ < 0) {
+    Stop();
+    return false;
+  }
+
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.u64 = k_wake_key;
+  if (epoll_ctl(epoll_descriptor_, EPOLL_CTL_ADD, wake_descriptor_, &event) !=
+      0) {
+    Stop();
+    return false;
+  }
+
+  stopping_ = false;
+  thread_ = std::thread(&ProcessMonitor::Loop, this);
+  return true;
+}
+
+void ProcessMonitor::Stop() {
+  if (thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    const uint64_t value = 1;
+    [[maybe_unused]] const ssize_t written =
+        write(wake_descriptor_, &value, sizeof(value));
+    thread_.join();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& [key, watched] : watched_) {
+    close(watched.descriptor);
+  }
+  watched_.clear();
+  for (const auto& [key, timer] : timers_) {
+    close(timer.descriptor);
+  }
+  timers_.clear();
+  if (wake_descriptor_ >= 0) {
+    close(wake_descriptor_);
+    wake_descriptor_ = -1;
+  }
+  if (epoll_descriptor_ >= 0) {
+    close(epoll_descriptor_);
+    epoll_descriptor_ = -1;
+  }
+}
+
+bool ProcessMonitor::Watch(const std::shared_ptr<LoafItem>& item) {
+  if (!item || !IsActive()) {
+    return false;
+  }
+
+  const int descriptor = item->DuplicatePollDescriptor();
+  if (descriptor < 0) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint64_t key = next_key_++;
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.u64 = key;
+  if (epoll_ctl(epoll_descriptor_, EPOLL_CTL_ADD, descriptor, &event) != 0) {
+    close(descriptor);
+    return false;
+  }
+  watched_[key] = Watched{item, item->GetProcessId(), descriptor};
+  return true;
+}
+
+bool ProcessMonitor::ScheduleAfter(std::chrono::milliseconds delay,
+                                   Task task) {
+  if (!task || !IsActive()) {
+    return false;
+  }
+
+  const int descriptor =
+      timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+  if (descriptor < 0) {
+    return false;
+  }
+  const auto nanoseconds =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(delay).count();
+  itimerspec spec{};
+  spec.it_value.tv_sec = static_cast<time_t>(nanoseconds / 1000000000);
+  spec.it_value.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+  if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+    spec.it_value.tv_nsec = 1;
+  }
+  if (timerfd_settime(descriptor, 0, &spec, nullptr) != 0) {
+    close(descriptor);
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint64_t key = next_key_++;
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.u64 = key;
+  if (epoll_ctl(epoll_descriptor_, EPOLL_CTL_ADD, descriptor, &event) != 0) {
+    close(descriptor);
+    return false;
+  }
+  timers_[key] = Timer{descriptor, std::move(task)};
+  return true;
+}
+
+void ProcessMonitor::CancelScheduled() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& [key, timer] : timers_) {
+    epoll_ctl(epoll_descriptor_, EPOLL_CTL_DEL, timer.descriptor, nullptr);
+    close(timer.descriptor);
+  }
+  timers_.clear();
+}
+
+bool ProcessMonitor::TakeTimer(uint64_t key, Task* task) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = timers_.find(key);
+  if (it == timers_.end()) {
+    return false;
+  }
+  epoll_ctl(epoll_descriptor_, EPOLL_CTL_DEL, it->second.descriptor, nullptr);
+  close(it->second.descriptor);
+  *task = std::move(it->second.task);
+  timers_.erase(it);
+  return true;
+}
+
+void ProcessMonitor::Remove(uint64_t key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = watched_.find(key);
+  if (it == watched_.end()) {
+    return;
+  }
+  epoll_ctl(epoll_descriptor_, EPOLL_CTL_DEL, it->second.descriptor, nullptr);
+  close(it->second.descriptor);
+  watched_.erase(it);
+}
+
+void ProcessMonitor::Loop() {
+  epoll_event events[k_max_events];
+  while (true) {
+    const int count = epoll_wait(epoll_descriptor_, events, k_max_events, -1);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+
+    for (int i = 0; i < count; ++i) {
+      const uint64_t key = events[i].data.u64;
+      if (key == k_wake_key) {
+        uint64_t value = 0;
+        [[maybe_unused]] const ssize_t read_bytes =
+            read(wake_descriptor_, &value, sizeof(value));
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+          return;
+        }
+        continue;
+      }
+
+      Task task;
+      if (TakeTimer(key, &task)) {
+        task();
+        continue;
+      }
+
+      Watched watched;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = watched_.find(key);
+        if (it == watched_.end()) {
+          continue;
+        }
+        watched = it->second;
+      }
+      Remove(key);
+
+      auto item = watched.item.lock();
+      if (!item) {
+        continue;
+      }
+      if (item->GetProcessId() != watched.process_id &&
+          item->GetProcessId() > 0) {
+        continue;
+      }
+      if (!item->IsProcessRunning() && callback_) {
+        callback_(ItemEvent{item->GetId(), ItemState::EXITED,
+                            item->GetLastExitCode()});
+      }
+    }
+  }
+}
+#else
+bool ProcessMonitor::Start() { return false; }
+
+void ProcessMonitor::Stop() {}
+
+bool ProcessMonitor::Watch(const std::shared_ptr<LoafItem>& item) {
+  return false;
+}
+
+bool ProcessMonitor::ScheduleAfter(std::chrono::milliseconds delay,
+                                   Task task) {
+  return false;
+}
+
+void ProcessMonitor::CancelScheduled() {}
+
+bool ProcessMonitor::TakeTimer(uint64_t key, Task* task) { return false; }
+
+void ProcessMonitor::Remove(uint64_t key) {}
+
+void ProcessMonitor::Loop() {}
+#endif
+
+}  // namespace BreadBin
\ No newline at end of file
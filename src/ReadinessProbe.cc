@@ -0,0 +1,352 @@
+#include "ReadinessProbe.h"
+
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/timerfd.h>
+#endif
+
+namespace BreadBin {
+namespace {
+constexpr int k_connect_timeout_ms = 50;
+constexpr int k_port_retry_interval_ms = 50;
+constexpr int k_fallback_poll_interval_ms = 50;
+constexpr size_t k_log_read_size = 64 * 1024;
+
+int ParseInteger(const std::string& value, int fallback) {
+  int result = fallback;
+  std::from_chars(value.data(), value.data() + value.size(), result);
+  return result;
+}
+
+std::string ParentDirectory(const std::string& path) {
+  const auto slash = path.find_last_of('/');
+  if (slash == std::string::npos) {
+    return ".";
+  }
+  return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+uint64_t CurrentFileSize(const std::string& path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    return 0;
+  }
+  return static_cast<uint64_t>(file.tellg());
+}
+
+#ifndef _WIN32
+bool ConnectLocal(const sockaddr* address, socklen_t length, int family) {
+  const int socket_descriptor =
+      socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (socket_descriptor < 0) {
+    return false;
+  }
+
+  bool connected = connect(socket_descriptor, address, length) == 0;
+  if (!connected && errno == EINPROGRESS) {
+    pollfd descriptor{socket_descriptor, POLLOUT, 0};
+    if (poll(&descriptor, 1, k_connect_timeout_ms) == 1) {
+      int error = 0;
+      socklen_t error_length = sizeof(error);
+      connected = getsockopt(socket_descriptor, SOL_SOCKET, SO_ERROR, &error,
+                             &error_length) == 0 &&
+                  error == 0;
+    }
+  }
+  close(socket_descriptor);
+  return connected;
+}
+#endif
+
+#ifdef __linux__
+enum class Source : uint32_t { INOTIFY, DELAY, RETRY, TIMEOUT, PROCESS, CANCEL };
+
+int CreateTimer(int delay_ms, int interval_ms) {
+  const int descriptor =
+      timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (descriptor < 0) {
+    return -1;
+  }
+  itimerspec spec{};
+  delay_ms = delay_ms > 0 ? delay_ms : 1;
+  spec.it_value.tv_sec = delay_ms / 1000;
+  spec.it_value.tv_nsec = static_cast<long>(delay_ms % 1000) * 1000000L;
+  spec.it_interval.tv_sec = interval_ms / 1000;
+  spec.it_interval.tv_nsec = static_cast<long>(interval_ms % 1000) * 1000000L;
+  timerfd_settime(descriptor, 0, &spec, nullptr);
+  return descriptor;
+}
+
+bool AddSource(int epoll_descriptor, int descriptor, Source source) {
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.u32 = static_cast<uint32_t>(source);
+  return epoll_ctl(epoll_descriptor, EPOLL_CTL_ADD, descriptor, &event) == 0;
+}
+
+void Drain(int descriptor) {
+  char buffer[4096];
+  while (read(descriptor, buffer, sizeof(buffer)) > 0) {
+  }
+}
+#endif
+}  // namespace
+
+bool ReadinessSpec::IsEmpty() const {
+  return file.empty() && port <= 0 && log_file.empty() && delay_ms <= 0;
+}
+
+ReadinessSpec ReadinessSpec::FromItem(const LoafItem& item) {
+  ReadinessSpec spec;
+  spec.file = item.GetMetadata("ready_file");
+  spec.port = ParseInteger(item.GetMetadata("ready_port"), 0);
+  spec.log_file = item.GetMetadata("ready_log_file");
+  spec.log_match = item.GetMetadata("ready_log_match");
+  spec.delay_ms = ParseInteger(item.GetMetadata("ready_delay_ms"), 0);
+  spec.timeout_ms =
+      ParseInteger(item.GetMetadata("ready_timeout_ms"), spec.timeout_ms);
+  return spec;
+}
+
+ReadinessProbe::ReadinessProbe(ReadinessSpec spec)
+    : spec_(std::move(spec)),
+      log_offset_(spec_.log_file.empty() ? 0
+                                         : CurrentFileSize(spec_.log_file)),
+      log_matched_(spec_.log_file.empty()),
+      delay_elapsed_(spec_.delay_ms <= 0) {}
+
+const std::string& ReadinessProbe::GetError() const { return error_; }
+
+bool ReadinessProbe::IsSatisfied() {
+  return delay_elapsed_ && CheckFile() && CheckLog() && CheckPort();
+}
+
+bool ReadinessProbe::CheckFile() const {
+  if (spec_.file.empty()) {
+    return true;
+  }
+#ifdef _WIN32
+  std::ifstream file(spec_.file);
+  return file.good();
+#else
+  struct stat info {};
+  return stat(spec_.file.c_str(), &info) == 0;
+#endif
+}
+
+bool ReadinessProbe::CheckPort() const {
+  if (spec_.port <= 0) {
+    return true;
+  }
+#ifdef _WIN32
+  return true;
+#else
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(static_cast<uint16_t>(spec_.port));
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (ConnectLocal(reinterpret_cast<const sockaddr*>(&address),
+                   sizeof(address), AF_INET)) {
+    return true;
+  }
+
+  sockaddr_in6 address6{};
+  address6.sin6_family = AF_INET6;
+  address6.sin6_port = htons(static_cast<uint16_t>(spec_.port));
+  address6.sin6_addr = in6addr_loopback;
+  return ConnectLocal(reinterpret_cast<const sockaddr*>(&address6),
+                      sizeof(address6), AF_INET6);
+#endif
+}
+
+bool ReadinessProbe::CheckLog() {
+  if (log_matched_) {
+    return true;
+  }
+
+  std::ifstream file(spec_.log_file, std::ios::binary | std::ios::ate);
+  if (!file.is_open()) {
+    return false;
+  }
+  const auto size = static_cast<uint64_t>(file.tellg());
+  if (size < log_offset_) {
+    log_offset_ = 0;
+    log_partial_line_.clear();
+  }
+  file.seekg(static_cast<std::streamoff>(log_offset_));
+
+  std::string buffer(k_log_read_size, '\0');
+  while (!log_matched_ && file.read(buffer.data(), buffer.size()).gcount() > 0) {
+    const auto count = static_cast<size_t>(file.gcount());
+    log_offset_ += count;
+    log_partial_line_.append(buffer.data(), count);
+
+    size_t line_start = 0;
+    size_t newline = 0;
+    while ((newline = log_partial_line_.find('\n', line_start)) !=
+           std::string::npos) {
+      const std::string_view line =
+          std::string_view(log_partial_line_)
+              .substr(line_start, newline - line_start);
+      if (line.find(spec_.log_match) != std::string_view::npos) {
+        log_matched_ = true;
+        break;
+      }
+      line_start = newline + 1;
+    }
+    log_partial_line_.erase(0, line_start);
+  }
+  return log_matched_;
+}
+
+#ifdef __linux__
+bool ReadinessProbe::Wait(LoafItem& item, int cancel_descriptor) {
+  if (IsSatisfied()) {
+    return true;
+  }
+
+  const int epoll_descriptor = epoll_create1(EPOLL_CLOEXEC);
+  const int inotify_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+  // A parent directory that does not exist yet cannot be watched, so such
+  // paths are polled on the retry timer instead.
+  bool poll_files = false;
+  for (const auto* path : {&spec_.file, &spec_.log_file}) {
+    if (!path->empty() &&
+        (inotify_descriptor < 0 ||
+         inotify_add_watch(inotify_descriptor, ParentDirectory(*path).c_str(),
+                           IN_CREATE | IN_MOVED_TO | IN_MODIFY |
+                               IN_CLOSE_WRITE) < 0)) {
+      poll_files = true;
+    }
+  }
+
+  const bool has_timeout = spec_.timeout_ms > 0;
+  const int timeout_timer = has_timeout ? CreateTimer(spec_.timeout_ms, 0) : -1;
+  const int delay_timer =
+      delay_elapsed_ ? -1 : CreateTimer(spec_.delay_ms, 0);
+  const int retry_interval_ms =
+      poll_files ? k_fallback_poll_interval_ms : k_port_retry_interval_ms;
+  const bool needs_retry = spec_.port > 0 || poll_files;
+  const int retry_timer =
+      needs_retry ? CreateTimer(retry_interval_ms, retry_interval_ms) : -1;
+  int process_descriptor = item.DuplicatePollDescriptor();
+
+  bool ok = epoll_descriptor >= 0 && inotify_descriptor >= 0 &&
+            (!has_timeout || timeout_timer >= 0) &&
+            (delay_elapsed_ || delay_timer >= 0) &&
+            (!needs_retry || retry_timer >= 0);
+  if (ok) {
+    ok = AddSource(epoll_descriptor, inotify_descriptor, Source::INOTIFY) &&
+         (timeout_timer < 0 ||
+          AddSource(epoll_descriptor, timeout_timer, Source::TIMEOUT)) &&
+         (delay_timer < 0 ||
+          AddSource(epoll_descriptor, delay_timer, Source::DELAY)) &&
+         (retry_timer < 0 ||
+          AddSource(epoll_descriptor, retry_timer, Source::RETRY)) &&
+         (process_descriptor < 0 ||
+          AddSource(epoll_descriptor, process_descriptor, Source::PROCESS)) &&
+         (cancel_descriptor < 0 ||
+          AddSource(epoll_descriptor, cancel_descriptor, Source::CANCEL));
+  }
+  if (!ok) {
+    error_ = "Could not set up readiness probe";
+  }
+
+  bool ready = false;
+  while (ok && !ready) {
+    epoll_event events[8];
+    const int count = epoll_wait(epoll_descriptor, events, 8, -1);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      error_ = "Readiness wait failed";
+      break;
+    }
+
+    for (int i = 0; i < count && ok; ++i) {
+      switch (static_cast<Source>(events[i].data.u32)) {
+        case Source::INOTIFY:
+          Drain(inotify_descriptor);
+          break;
+        case Source::DELAY:
+          Drain(delay_timer);
+          delay_elapsed_ = true;
+          break;
+        case Source::RETRY:
+          Drain(retry_timer);
+          break;
+        case Source::TIMEOUT:
+          error_ = "Not ready after " + std::to_string(spec_.timeout_ms) +
+                   " ms";
+          ok = false;
+          break;
+        case Source::PROCESS:
+          epoll_ctl(epoll_descriptor, EPOLL_CTL_DEL, process_descriptor,
+                    nullptr);
+          if (!item.IsProcessRunning() && item.GetLastExitCode() != 0) {
+            error_ = "Exited with code " +
+                     std::to_string(item.GetLastExitCode()) +
+                     " before becoming ready";
+            ok = false;
+          }
+          break;
+        case Source::CANCEL:
+          error_ = "Launch cancelled";
+          ok = false;
+          break;
+      }
+    }
+    ready = ok && IsSatisfied();
+  }
+
+  for (const int descriptor : {epoll_descriptor, inotify_descriptor,
+                               timeout_timer, delay_timer, retry_timer,
+                               process_descriptor}) {
+    if (descriptor >= 0) {
+      close(descriptor);
+    }
+  }
+  return ready;
+}
+#else
+bool ReadinessProbe::Wait(LoafItem& item, int cancel_descriptor) {
+  const auto start = std::chrono::steady_clock::now();
+  while (true) {
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    delay_elapsed_ = elapsed >= spec_.delay_ms;
+    if (IsSatisfied()) {
+      return true;
+    }
+    if (spec_.timeout_ms > 0 && elapsed >= spec_.timeout_ms) {
+      error_ = "Not ready after " + std::to_string(spec_.timeout_ms) + " ms";
+      return false;
+    }
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(k_fallback_poll_interval_ms));
+  }
+}
+#endif
+
+}  // namespace BreadBin
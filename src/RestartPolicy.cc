@@ -0,0 +1,77 @@
+#include "RestartPolicy.h"
+
+#include <algorithm>
+#include <charconv>
+#include <string>
+
+namespace BreadBin {
+namespace {
+int ParseInteger(const std::string& value, int fallback) {
+  int result = fallback;
+  std::from_chars(value.data(), value.data() + value.size(), result);
+  return std::max(0, result);
+}
+
+RestartMode ParseMode(const std::string& value) {
+  if (value == "always") {
+    return RestartMode::ALWAYS;
+  }
+  if (value == "on-failure" || value == "on_failure") {
+    return RestartMode::ON_FAILURE;
+  }
+  return RestartMode::NEVER;
+}
+}  // namespace
+
+bool RestartPolicy::ShouldRestart(int exit_code) const {
+  switch (mode) {
+    case RestartMode::ALWAYS:
+      return true;
+    case RestartMode::ON_FAILURE:
+      return exit_code != 0;
+    default:
+      return false;
+  }
+}
+
+RestartPolicy RestartPolicy::FromItem(const LoafItem& item) {
+  RestartPolicy policy;
+  policy.mode = ParseMode(item.GetMetadata("restart"));
+  policy.max_restarts =
+      ParseInteger(item.GetMetadata("restart_max"), policy.max_restarts);
+  policy.window = std::chrono::milliseconds(ParseInteger(
+      item.GetMetadata("restart_window_ms"),
+      static_cast<int>(policy.window.count())));
+  policy.initial_backoff = std::chrono::milliseconds(ParseInteger(
+      item.GetMetadata("restart_backoff_ms"),
+      static_cast<int>(policy.initial_backoff.count())));
+  policy.max_backoff = std::chrono::milliseconds(ParseInteger(
+      item.GetMetadata("restart_backoff_max_ms"),
+      static_cast<int>(policy.max_backoff.count())));
+  return policy;
+}
+
+bool RestartTracker::NextDelay(const RestartPolicy& policy,
+                               Clock::time_point now,
+                               std::chrono::milliseconds* delay) {
+  while (!recent_.empty() && now - recent_.front() >= policy.window) {
+    recent_.pop_front();
+  }
+  if (static_cast<int>(recent_.size()) >= policy.max_restarts) {
+    return false;
+  }
+
+  std::chrono::milliseconds backoff = policy.initial_backoff;
+  for (size_t i = 0; i < recent_.size() && backoff < policy.max_backoff;
+       ++i) {
+    backoff *= 2;
+  }
+  *delay = std::min(backoff, policy.max_backoff);
+  recent_.push_back(now);
+  ++restart_count_;
+  return true;
+}
+
+int RestartTracker::GetRestartCount() const { return restart_count_; }
+
+}  // namespace BreadBin
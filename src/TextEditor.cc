@@ -3,6 +3,8 @@
 #include <fstream>
 #include <sstream>
 
+#include "AtomicFileWriter.h"
+
 namespace BreadBin {
 TextEditor::TextEditor() : current_file_path_(""), unsaved_changes_(false) {}
 
@@ -27,18 +29,18 @@ bool TextEditor::OpenFile(const std::string& filepath) {
 }
 
 bool TextEditor::SaveFile(const std::string& filepath) {
-  std::ofstream file(filepath);
-  if (!file.is_open()) {
-    return false;
-  }
+  AtomicFileWriter writer(filepath);
+  std::ostream& file = writer.Stream();
 
   for (const auto& line : lines_) {
     file << line << "\n";
   }
 
+  if (!writer.Commit()) {
+    return false;
+  }
   current_file_path_ = filepath;
   unsaved_changes_ = false;
-  file.close();
   return true;
 }
 
@@ -5,6 +5,8 @@
 #include <sstream>
 #include <vector>
 
+#include "AtomicFileWriter.h"
+
 namespace BreadBin {
 namespace {
 constexpr int k_default_alpha = 255;
@@ -203,10 +205,8 @@ bool ThemeEditor::LoadTheme(const std::string& filepath) {
 }
 
 bool ThemeEditor::SaveTheme(const std::string& filepath) {
-  std::ofstream file(filepath);
-  if (!file.is_open()) {
-    return false;
-  }
+  AtomicFileWriter writer(filepath);
+  std::ostream& file = writer.Stream();
 
   file << "NAME=" << theme_name_ << "\n";
 
@@ -242,7 +242,9 @@ bool ThemeEditor::SaveTheme(const std::string& filepath) {
     file << style.first << "=" << style.second << "\n";
   }
 
-  file.close();
+  if (!writer.Commit()) {
+    return false;
+  }
   unsaved_changes_ = false;
   return true;
 }
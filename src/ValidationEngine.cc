@@ -0,0 +1,111 @@
+#include "ValidationEngine.h"
+
+#include "ParallelFor.h"
+
+namespace BreadBin {
+namespace {
+std::string MakeCheckKey(const LoafItem& item) {
+  return std::to_string(static_cast<int>(item.GetType())) + '\0' +
+         item.GetPath();
+}
+
+std::string DescribeFailure(const LoafItem& item) {
+  if (item.GetPath().empty()) {
+    return "No path set";
+  }
+  switch (item.GetType()) {
+    case LoafItem::Type::APPLICATION:
+    case LoafItem::Type::SCRIPT:
+      return "Not an executable file";
+    case LoafItem::Type::CONFIG:
+      return "Not a readable regular file";
+    case LoafItem::Type::WEBPAGE:
+      return "Not an http(s) URL";
+    default:
+      return "Path is missing or not readable";
+  }
+}
+}  // namespace
+
+ValidationEngine::ValidationEngine(size_t max_workers,
+                                   std::chrono::milliseconds ttl)
+    : max_workers_(max_workers), ttl_(ttl) {}
+
+ValidationReport ValidationEngine::Validate(
+    const std::vector<std::shared_ptr<Loaf>>& loafs) {
+  struct Check {
+    std::string key;
+    std::shared_ptr<LoafItem> item;
+    bool valid = false;
+  };
+  struct Use {
+    size_t loaf_index;
+    std::shared_ptr<LoafItem> item;
+    size_t check;
+  };
+
+  ValidationReport report;
+  std::unordered_map<std::string, size_t> check_by_key;
+  std::vector<Check> checks;
+  std::vector<Use> uses;
+  for (size_t loaf_index = 0; loaf_index < loafs.size(); ++loaf_index) {
+    if (!loafs[loaf_index]) {
+      continue;
+    }
+    for (const auto& item : loafs[loaf_index]->GetItems()) {
+      std::string key = MakeCheckKey(*item);
+      auto [it, inserted] = check_by_key.emplace(key, checks.size());
+      if (inserted) {
+        checks.push_back(Check{std::move(key), item});
+      }
+      uses.push_back(Use{loaf_index, item, it->second});
+    }
+  }
+  report.item_count = uses.size();
+  report.unique_checks = checks.size();
+
+  std::vector<size_t> pending;
+  const auto now = Clock::now();
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    for (size_t i = 0; i < checks.size(); ++i) {
+      auto cached = cache_.find(checks[i].key);
+      if (cached != cache_.end() && now - cached->second.checked < ttl_) {
+        checks[i].valid = cached->second.valid;
+        ++report.cache_hits;
+      } else {
+        pending.push_back(i);
+      }
+    }
+  }
+
+  ParallelFor(pending.size(), max_workers_, [&](size_t i) {
+    Check& check = checks[pending[i]];
+    check.valid = check.item->Validate();
+  });
+
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    const auto checked = Clock::now();
+    for (size_t index : pending) {
+      cache_[checks[index].key] = CachedResult{checks[index].valid, checked};
+    }
+  }
+
+  for (const auto& use : uses) {
+    if (!checks[use.check].valid) {
+      report.broken.push_back(ValidationIssue{use.loaf_index,
+                                              use.item->GetId(),
+                                              use.item->GetPath(),
+                                              DescribeFailure(*use.item)});
+    }
+  }
+  return report;
+}
+
+void ValidationEngine::ClearCache() {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  cache_.clear();
+}
+
+}  // namespace BreadBin
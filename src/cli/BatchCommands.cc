@@ -0,0 +1,245 @@
+#include "cli/BatchCommands.h"
+
+#include <algorithm>
+#include <filesystem>
+
+#include "ControlProtocol.h"
+#include "DependencyGraph.h"
+#include "Loaf.h"
+#include "LoafBinaryFormat.h"
+#include "ParallelFor.h"
+#include "ValidationEngine.h"
+
+namespace BreadBin::Cli {
+namespace {
+constexpr const char* k_text_extension = ".loaf";
+constexpr const char* k_binary_extension = ".loafb";
+
+bool EndsWith(const std::string& value, const std::string& suffix) {
+  return value.size() >= suffix.size() &&
+         value.compare(value.size() - suffix.size(), suffix.size(), suffix) ==
+             0;
+}
+
+std::string ReplaceExtension(const std::string& file, bool to_binary) {
+  std::string stem = file;
+  if (EndsWith(stem, k_binary_extension)) {
+    stem.resize(stem.size() - std::char_traits<char>::length(k_binary_extension));
+  } else if (EndsWith(stem, k_text_extension)) {
+    stem.resize(stem.size() - std::char_traits<char>::length(k_text_extension));
+  }
+  return stem + (to_binary ? k_binary_extension : k_text_extension);
+}
+
+const char* ToTypeName(LoafItem::Type type) {
+  switch (type) {
+    case LoafItem::Type::APPLICATION:
+      return "applications";
+    case LoafItem::Type::FILE:
+      return "files";
+    case LoafItem::Type::CONFIG:
+      return "configs";
+    case LoafItem::Type::SCRIPT:
+      return "scripts";
+    case LoafItem::Type::WEBPAGE:
+      return "webpages";
+    default:
+      return "other";
+  }
+}
+
+bool LoadLoaf(const std::string& file, Loaf* loaf, FileReport* report) {
+  if (loaf->Load(file)) {
+    return true;
+  }
+  report->AddError(loaf->GetLastError().empty() ? file + ": cannot load loaf"
+                                                : loaf->GetLastError());
+  return false;
+}
+}  // namespace
+
+bool BatchCommands::IsCommand(const std::string& command) {
+  return command == "run" || command == "stop" || command == "validate" ||
+         command == "convert" || command == "list" || command == "stats";
+}
+
+std::vector<FileReport> BatchCommands::Run(const std::string& command,
+                                           const BatchOptions& options) {
+  if (command == "validate") {
+    return ValidateAll(options);
+  }
+
+  std::vector<FileReport> reports(options.files.size());
+  ParallelFor(options.files.size(), options.jobs, [&](size_t index) {
+    const std::string& file = options.files[index];
+    if (command == "convert") {
+      reports[index] = Convert(file, options);
+    } else if (command == "list") {
+      reports[index] = List(file);
+    } else if (command == "stats") {
+      reports[index] = Stats(file);
+    } else {
+      reports[index] = Control(command, file, options);
+    }
+    reports[index].file = file;
+  });
+  return reports;
+}
+
+std::vector<FileReport> BatchCommands::ValidateAll(
+    const BatchOptions& options) {
+  const size_t count = options.files.size();
+  std::vector<FileReport> reports(count);
+  std::vector<std::shared_ptr<Loaf>> loafs(count);
+  ParallelFor(count, options.jobs, [&](size_t index) {
+    FileReport& report = reports[index];
+    report.file = options.files[index];
+    auto loaf = std::make_shared<Loaf>();
+    if (!LoadLoaf(report.file, loaf.get(), &report)) {
+      return;
+    }
+
+    report.Add("items", static_cast<int64_t>(loaf->GetItems().size()));
+    const auto graph = loaf->GetDependencyGraph();
+    if (graph->HasCycle()) {
+      report.AddError(graph->DescribeCycle());
+    }
+    report.Add("warnings", graph->GetWarnings());
+    loafs[index] = std::move(loaf);
+  });
+
+  ValidationEngine engine(options.jobs);
+  const ValidationReport validation = engine.Validate(loafs);
+  for (const auto& issue : validation.broken) {
+    std::string message = "item '" + issue.item_id + "': " + issue.reason;
+    if (!issue.path.empty()) {
+      message += " '" + issue.path + "'";
+    }
+    reports[issue.loaf_index].AddError(message);
+  }
+  return reports;
+}
+
+FileReport BatchCommands::Convert(const std::string& file,
+                                  const BatchOptions& options) {
+  FileReport report;
+  const bool is_binary = LoafBinaryReader::IsBinaryLoaf(file);
+  bool to_binary = !is_binary;
+  if (options.convert_format == "binary") {
+    to_binary = true;
+  } else if (options.convert_format == "text") {
+    to_binary = false;
+  } else if (!options.convert_format.empty()) {
+    report.AddError("unknown format '" + options.convert_format + "'");
+    return report;
+  }
+
+  Loaf loaf;
+  if (!LoadLoaf(file, &loaf, &report)) {
+    return report;
+  }
+
+  const std::string output = options.output_path.empty()
+                                 ? ReplaceExtension(file, to_binary)
+                                 : options.output_path;
+  if (output == file) {
+    report.AddError("output would overwrite the input file");
+    return report;
+  }
+  const bool saved = to_binary ? loaf.SaveBinary(output) : loaf.Save(output);
+  report.Add("output", output);
+  report.Add("format", std::string(to_binary ? "binary" : "text"));
+  if (!saved) {
+    report.AddError("cannot write " + output);
+  }
+  return report;
+}
+
+FileReport BatchCommands::List(const std::string& file) {
+  FileReport report;
+  LoafSummary summary;
+  if (!Loaf::ReadSummary(file, &summary)) {
+    report.AddError(file + ": cannot read loaf");
+    return report;
+  }
+
+  report.Add("name", summary.name);
+  report.Add("description", summary.description);
+  report.Add("layout", summary.layout);
+  report.Add("items", static_cast<int64_t>(summary.item_count));
+  report.Add("format", std::string(LoafBinaryReader::IsBinaryLoaf(file)
+                                       ? "binary"
+                                       : "text"));
+  return report;
+}
+
+FileReport BatchCommands::Stats(const std::string& file) {
+  FileReport report;
+  Loaf loaf;
+  if (!LoadLoaf(file, &loaf, &report)) {
+    return report;
+  }
+
+  report.Add("name", loaf.GetName());
+  report.Add("items", static_cast<int64_t>(loaf.GetItems().size()));
+  for (const auto type :
+       {LoafItem::Type::APPLICATION, LoafItem::Type::FILE,
+        LoafItem::Type::CONFIG, LoafItem::Type::SCRIPT,
+        LoafItem::Type::WEBPAGE}) {
+    report.Add(ToTypeName(type),
+               static_cast<int64_t>(std::count_if(
+                   loaf.GetItems().begin(), loaf.GetItems().end(),
+                   [type](const std::shared_ptr<LoafItem>& item) {
+                     return item->GetType() == type;
+                   })));
+  }
+
+  const auto graph = loaf.GetDependencyGraph();
+  int64_t edges = 0;
+  for (size_t i = 0; i < graph->GetNodeCount(); ++i) {
+    edges += static_cast<int64_t>(graph->GetDependencies(i).size());
+  }
+  report.Add("dependencies", edges);
+  report.Add("runtime_rules",
+             static_cast<int64_t>(loaf.GetRuntimeRules().size()));
+  if (graph->HasCycle()) {
+    report.AddError(graph->DescribeCycle());
+    return report;
+  }
+
+  std::vector<std::string> critical_path;
+  for (size_t index : graph->GetCriticalPath()) {
+    critical_path.push_back(graph->GetItem(index)->GetId());
+  }
+  report.Add("launch_levels", static_cast<int64_t>(graph->GetLevels().size()));
+  report.Add("critical_path", critical_path);
+  return report;
+}
+
+FileReport BatchCommands::Control(const std::string& command,
+                                  const std::string& file,
+                                  const BatchOptions& options) {
+  FileReport report;
+  ControlRequest request;
+  request.command =
+      command == "run" ? ControlCommand::START : ControlCommand::STOP;
+  std::error_code error_code;
+  const auto absolute = std::filesystem::absolute(file, error_code);
+  request.target = error_code ? file : absolute.lexically_normal().string();
+
+  ControlResponse response;
+  std::string error;
+  if (!ControlProtocol::Call(options.socket_path, request, &response,
+                             &error)) {
+    report.AddError("cannot reach breadbind: " + error);
+    return report;
+  }
+  if (!response.ok) {
+    report.AddError(response.message);
+    return report;
+  }
+  report.Add("message", response.message);
+  return report;
+}
+
+}  // namespace BreadBin::Cli
@@ -0,0 +1,100 @@
+#include "cli/ReportWriter.h"
+
+#include <algorithm>
+
+#include "JsonString.h"
+
+namespace BreadBin::Cli {
+namespace {
+void AppendJsonValue(std::string& out, const FieldValue& value) {
+  if (const auto* text = std::get_if<std::string>(&value)) {
+    AppendJsonString(out, *text);
+  } else if (const auto* number = std::get_if<int64_t>(&value)) {
+    out += std::to_string(*number);
+  } else if (const auto* flag = std::get_if<bool>(&value)) {
+    out += *flag ? "true" : "false";
+  } else {
+    const auto& list = std::get<std::vector<std::string>>(value);
+    out += '[';
+    for (size_t i = 0; i < list.size(); ++i) {
+      if (i > 0) {
+        out += ',';
+      }
+      AppendJsonString(out, list[i]);
+    }
+    out += ']';
+  }
+}
+
+std::string ToDisplayString(const FieldValue& value) {
+  if (const auto* text = std::get_if<std::string>(&value)) {
+    return *text;
+  }
+  if (const auto* number = std::get_if<int64_t>(&value)) {
+    return std::to_string(*number);
+  }
+  if (const auto* flag = std::get_if<bool>(&value)) {
+    return *flag ? "yes" : "no";
+  }
+  std::string joined;
+  for (const auto& entry : std::get<std::vector<std::string>>(value)) {
+    joined += joined.empty() ? entry : ", " + entry;
+  }
+  return joined;
+}
+}  // namespace
+
+void FileReport::Add(std::string key, FieldValue value) {
+  fields.push_back(Field{std::move(key), std::move(value)});
+}
+
+void FileReport::AddError(const std::string& error) {
+  ok = false;
+  auto it = std::find_if(fields.begin(), fields.end(),
+                         [](const Field& field) { return field.key == "errors"; });
+  if (it == fields.end()) {
+    Add("errors", std::vector<std::string>{error});
+  } else {
+    std::get<std::vector<std::string>>(it->value).push_back(error);
+  }
+}
+
+std::string ReportWriter::ToJson(const std::string& command,
+                                 const std::vector<FileReport>& reports) {
+  const bool ok = std::all_of(reports.begin(), reports.end(),
+                              [](const FileReport& report) { return report.ok; });
+  std::string out = "{\"command\":";
+  AppendJsonString(out, command);
+  out += ",\"ok\":";
+  out += ok ? "true" : "false";
+  out += ",\"results\":[";
+  for (size_t i = 0; i < reports.size(); ++i) {
+    const FileReport& report = reports[i];
+    out += i > 0 ? ",{\"file\":" : "{\"file\":";
+    AppendJsonString(out, report.file);
+    out += ",\"ok\":";
+    out += report.ok ? "true" : "false";
+    for (const auto& field : report.fields) {
+      out += ',';
+      AppendJsonString(out, field.key);
+      out += ':';
+      AppendJsonValue(out, field.value);
+    }
+    out += '}';
+  }
+  out += "]}\n";
+  return out;
+}
+
+std::string ReportWriter::ToText(const std::vector<FileReport>& reports) {
+  std::string out;
+  for (const auto& report : reports) {
+    out += report.file + ": " + (report.ok ? "OK" : "FAILED") + "\n";
+    for (const auto& field : report.fields) {
+      out += "  " + field.key + ": " + ToDisplayString(field.value) + "\n";
+    }
+  }
+  return out;
+}
+
+}  // namespace BreadBin::Cli
@@ -0,0 +1,461 @@
+#include "daemon/LoafDaemon.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace BreadBin::Daemon {
+namespace {
+constexpr int k_listen_backlog = 64;
+constexpr int k_max_events = 64;
+constexpr size_t k_read_size = 4096;
+
+std::string DescribeLoafState(const Loaf& loaf) {
+  if (loaf.IsLaunching()) {
+    return "launching";
+  }
+  return loaf.IsRunning() ? "running" : "stopped";
+}
+
+std::string CanonicalPath(const std::string& filepath) {
+#ifdef _WIN32
+  return filepath;
+#else
+  char resolved[PATH_MAX];
+  return realpath(filepath.c_str(), resolved) ? std::string(resolved)
+                                              : filepath;
+#endif
+}
+}  // namespace
+
+LoafDaemon::LoafDaemon(std::string socket_path)
+    : socket_path_(std::move(socket_path)),
+      listen_descriptor_(-1),
+      epoll_descriptor_(-1),
+      signal_descriptor_(-1),
+      wake_descriptor_(-1),
+      shutting_down_(false) {}
+
+const std::string& LoafDaemon::GetLastError() const { return last_error_; }
+
+bool LoafDaemon::StartLoaf(const std::string& filepath, std::string* error) {
+  const std::string id = CanonicalPath(filepath);
+  auto existing = loafs_.find(id);
+  if (existing != loafs_.end()) {
+    if (existing->second.stopper.joinable()) {
+      *error = id + ": loaf is stopping";
+      return false;
+    }
+    if (existing->second.loaf->IsRunning() ||
+        existing->second.loaf->IsLaunching()) {
+      *error = id + ": loaf is already running";
+      return false;
+    }
+  }
+
+  auto loaf = std::make_shared<Loaf>();
+  if (!loaf->Load(id)) {
+    *error = loaf->GetLastError().empty() ? id + ": cannot load loaf"
+                                          : loaf->GetLastError();
+    return false;
+  }
+
+  auto events = std::make_shared<ItemEvents>();
+  loaf->SetItemEventCallback([events](const ItemEvent& event) {
+    std::lock_guard<std::mutex> lock(events->mutex);
+    events->latest[event.item_id] = event;
+  });
+  loaf->RunAsync();
+
+  ManagedLoaf& managed = loafs_[id];
+  managed.loaf = std::move(loaf);
+  managed.events = std::move(events);
+  managed.stopped = std::make_shared<std::atomic<bool>>(false);
+  return true;
+}
+
+ControlResponse LoafDaemon::Status(const std::string& target) const {
+  ControlResponse response;
+  response.ok = true;
+  for (const auto& [id, managed] : loafs_) {
+    if (!target.empty() && id != target) {
+      continue;
+    }
+
+    LoafStatus status;
+    status.id = id;
+    status.name = managed.loaf->GetName();
+    status.state = managed.stopper.joinable()
+                       ? "stopping"
+                       : DescribeLoafState(*managed.loaf);
+    status.error = managed.loaf->GetLastError();
+    std::lock_guard<std::mutex> lock(managed.events->mutex);
+    for (const auto& item : managed.loaf->GetItems()) {
+      ItemStatus item_status;
+      item_status.id = item->GetId();
+      auto event = managed.events->latest.find(item_status.id);
+      if (event != managed.events->latest.end()) {
+        item_status.state = static_cast<uint8_t>(event->second.state);
+        item_status.exit_code = event->second.exit_code;
+        item_status.restart_count =
+            static_cast<uint32_t>(event->second.restart_count);
+      }
+      item_status.process_id = item->GetProcessId();
+      status.items.push_back(std::move(item_status));
+    }
+    response.loafs.push_back(std::move(status));
+  }
+
+  if (!target.empty() && response.loafs.empty()) {
+    response.ok = false;
+    response.message = target + ": no such loaf";
+  }
+  return response;
+}
+
+ControlResponse LoafDaemon::Handle(const ControlRequest& request) {
+  ControlResponse response;
+  switch (request.command) {
+    case ControlCommand::START:
+      response.ok = StartLoaf(request.target, &response.message);
+      if (response.ok) {
+        response.message = "started " + CanonicalPath(request.target);
+      }
+      break;
+    case ControlCommand::STOP:
+      response.ok = StopLoaf(CanonicalPath(request.target), &response.message);
+      if (response.ok) {
+        response.message = "stopping " + CanonicalPath(request.target);
+      }
+      break;
+    case ControlCommand::STATUS:
+      response = Status(request.target.empty() ? request.target
+                                               : CanonicalPath(request.target));
+      break;
+    case ControlCommand::SHUTDOWN:
+      shutting_down_ = true;
+      response.ok = true;
+      response.message = "shutting down";
+      break;
+  }
+  return response;
+}
+
+#ifdef __linux__
+LoafDaemon::~LoafDaemon() {
+  StopAll();
+  for (const auto& [descriptor, connection] : connections_) {
+    close(descriptor);
+  }
+  for (const int descriptor : {listen_descriptor_, epoll_descriptor_,
+                               signal_descriptor_, wake_descriptor_}) {
+    if (descriptor >= 0) {
+      close(descriptor);
+    }
+  }
+  if (listen_descriptor_ >= 0) {
+    unlink(socket_path_.c_str());
+  }
+}
+
+bool LoafDaemon::Start() {
+  auto fail = [this](const std::string& message) {
+    last_error_ = message;
+    return false;
+  };
+
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socket_path_.size() >= sizeof(address.sun_path)) {
+    return fail(socket_path_ + ": socket path too long");
+  }
+  std::memcpy(address.sun_path, socket_path_.c_str(), socket_path_.size() + 1);
+
+  ControlResponse probe;
+  if (ControlProtocol::Call(socket_path_, ControlRequest{}, &probe, nullptr)) {
+    return fail(socket_path_ + ": another daemon is already listening");
+  }
+  unlink(socket_path_.c_str());
+
+  listen_descriptor_ =
+      socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listen_descriptor_ < 0) {
+    return fail(std::strerror(errno));
+  }
+  const mode_t previous_mask = umask(0077);
+  const int bound = bind(listen_descriptor_,
+                         reinterpret_cast<const sockaddr*>(&address),
+                         sizeof(address));
+  umask(previous_mask);
+  if (bound != 0 || listen(listen_descriptor_, k_listen_backlog) != 0) {
+    const int bind_error = errno;
+    close(listen_descriptor_);
+    listen_descriptor_ = -1;
+    return fail(socket_path_ + ": " + std::strerror(bind_error));
+  }
+
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+  signal_descriptor_ = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+  wake_descriptor_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  epoll_descriptor_ = epoll_create1(EPOLL_CLOEXEC);
+  if (signal_descriptor_ < 0 || wake_descriptor_ < 0 ||
+      epoll_descriptor_ < 0) {
+    return fail(std::strerror(errno));
+  }
+
+  for (const int descriptor :
+       {listen_descriptor_, signal_descriptor_, wake_descriptor_}) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = descriptor;
+    if (epoll_ctl(epoll_descriptor_, EPOLL_CTL_ADD, descriptor, &event) != 0) {
+      return fail(std::strerror(errno));
+    }
+  }
+  return true;
+}
+
+void LoafDaemon::Run() {
+  epoll_event events[k_max_events];
+  while (!shutting_down_) {
+    const int count = epoll_wait(epoll_descriptor_, events, k_max_events, -1);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      last_error_ = std::strerror(errno);
+      break;
+    }
+
+    for (int i = 0; i < count; ++i) {
+      const int descriptor = events[i].data.fd;
+      if (descriptor == listen_descriptor_) {
+        Accept();
+      } else if (descriptor == signal_descriptor_) {
+        signalfd_siginfo info;
+        while (read(signal_descriptor_, &info, sizeof(info)) > 0) {
+        }
+        shutting_down_ = true;
+      } else if (descriptor == wake_descriptor_) {
+        uint64_t value = 0;
+        [[maybe_unused]] const ssize_t read_bytes =
+            read(wake_descriptor_, &value, sizeof(value));
+        ReapStopped();
+      } else {
+        if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+          ReadConnection(descriptor);
+        }
+        if (connections_.count(descriptor) &&
+            (events[i].events & EPOLLOUT)) {
+          FlushConnection(descriptor);
+        }
+      }
+    }
+  }
+  StopAll();
+}
+
+bool LoafDaemon::StopLoaf(const std::string& id, std::string* error) {
+  auto it = loafs_.find(id);
+  if (it == loafs_.end()) {
+    *error = id + ": no such loaf";
+    return false;
+  }
+
+  ManagedLoaf& managed = it->second;
+  if (managed.stopper.joinable()) {
+    *error = id + ": loaf is already stopping";
+    return false;
+  }
+  managed.stopper = std::thread(
+      [this, loaf = managed.loaf, stopped = managed.stopped]() {
+        loaf->Stop();
+        *stopped = true;
+        Wake();
+      });
+  return true;
+}
+
+void LoafDaemon::StopAll() {
+  for (auto& [id, managed] : loafs_) {
+    if (!managed.stopper.joinable()) {
+      managed.stopper = std::thread([loaf = managed.loaf]() { loaf->Stop(); });
+    }
+  }
+  for (auto& [id, managed] : loafs_) {
+    managed.stopper.join();
+  }
+  loafs_.clear();
+}
+
+void LoafDaemon::ReapStopped() {
+  for (auto it = loafs_.begin(); it != loafs_.end();) {
+    if (it->second.stopper.joinable() && *it->second.stopped) {
+      it->second.stopper.join();
+      it = loafs_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void LoafDaemon::Wake() {
+  const uint64_t value = 1;
+  [[maybe_unused]] const ssize_t written =
+      write(wake_descriptor_, &value, sizeof(value));
+}
+
+void LoafDaemon::Accept() {
+  while (true) {
+    const int descriptor = accept4(listen_descriptor_, nullptr, nullptr,
+                                   SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (descriptor < 0) {
+      return;
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = descriptor;
+    if (epoll_ctl(epoll_descriptor_, EPOLL_CTL_ADD, descriptor, &event) != 0) {
+      close(descriptor);
+      continue;
+    }
+    connections_[descriptor] = Connection();
+  }
+}
+
+void LoafDaemon::ReadConnection(int descriptor) {
+  auto it = connections_.find(descriptor);
+  if (it == connections_.end()) {
+    return;
+  }
+
+  Connection& connection = it->second;
+  char chunk[k_read_size];
+  bool closed = false;
+  while (true) {
+    const ssize_t received = recv(descriptor, chunk, sizeof(chunk), 0);
+    if (received > 0) {
+      connection.input.append(chunk, static_cast<size_t>(received));
+      continue;
+    }
+    if (received < 0 && errno == EINTR) {
+      continue;
+    }
+    closed = received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+    break;
+  }
+
+  std::string payload;
+  bool malformed = false;
+  while (ControlProtocol::TakeFrame(&connection.input, &payload, &malformed)) {
+    ControlRequest request;
+    ControlResponse response;
+    if (ControlProtocol::DecodeRequest(payload, &request)) {
+      response = Handle(request);
+    } else {
+      response.message = "Malformed request";
+    }
+    connection.output +=
+        ControlProtocol::Frame(ControlProtocol::EncodeResponse(response));
+  }
+
+  if (malformed) {
+    CloseConnection(descriptor);
+    return;
+  }
+  FlushConnection(descriptor);
+  if (closed && connections_.count(descriptor)) {
+    CloseConnection(descriptor);
+  }
+}
+
+void LoafDaemon::FlushConnection(int descriptor) {
+  auto it = connections_.find(descriptor);
+  if (it == connections_.end()) {
+    return;
+  }
+
+  std::string& output = it->second.output;
+  while (!output.empty()) {
+    const ssize_t sent =
+        send(descriptor, output.data(), output.size(), MSG_NOSIGNAL);
+    if (sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        CloseConnection(descriptor);
+        return;
+      }
+      break;
+    }
+    output.erase(0, static_cast<size_t>(sent));
+  }
+
+  epoll_event event{};
+  event.events = output.empty() ? EPOLLIN : (EPOLLIN | EPOLLOUT);
+  event.data.fd = descriptor;
+  epoll_ctl(epoll_descriptor_, EPOLL_CTL_MOD, descriptor, &event);
+}
+
+void LoafDaemon::CloseConnection(int descriptor) {
+  epoll_ctl(epoll_descriptor_, EPOLL_CTL_DEL, descriptor, nullptr);
+  close(descriptor);
+  connections_.erase(descriptor);
+}
+#else
+LoafDaemon::~LoafDaemon() { StopAll(); }
+
+bool LoafDaemon::Start() {
+  last_error_ = "breadbind is only supported on Linux";
+  return false;
+}
+
+void LoafDaemon::Run() {}
+
+bool LoafDaemon::StopLoaf(const std::string& id, std::string* error) {
+  *error = "breadbind is only supported on Linux";
+  return false;
+}
+
+void LoafDaemon::StopAll() {
+  for (auto& [id, managed] : loafs_) {
+    managed.loaf->Stop();
+  }
+  loafs_.clear();
+}
+
+void LoafDaemon::ReapStopped() {}
+
+void LoafDaemon::Wake() {}
+
+void LoafDaemon::Accept() {}
+
+void LoafDaemon::ReadConnection(int descriptor) {}
+
+void LoafDaemon::FlushConnection(int descriptor) {}
+
+void LoafDaemon::CloseConnection(int descriptor) {}
+#endif
+
+}  // namespace BreadBin::Daemon
@@ -6,23 +6,48 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QMessageBox>
-#include <QProgressDialog>
 #include <QVBoxLayout>
 
 namespace BreadBin::GUI {
 AppBrowserWidget::AppBrowserWidget(QWidget* parent)
-    : QWidget(parent), discovery_(std::make_shared<AppDiscovery>()) {
+    : QWidget(parent),
+      discovery_(std::make_shared<AppDiscovery>()),
+      scanner_(std::make_unique<AppDiscovery>()),
+      scan_cancelled_(false),
+      rescan_pending_(false) {
   SetupUI();
   ConnectSignals();
 
   QString cache_file = QDir::homePath() + "/.breadbin_app_cache";
-  if (QFileInfo::exists(cache_file)) {
-    discovery_->LoadCache(cache_file.toStdString());
+  bool is_fresh = false;
+  if (QFileInfo::exists(cache_file) &&
+      discovery_->LoadCache(cache_file.toStdString(), &is_fresh)) {
+    PopulateCategories();
     UpdateApplicationList();
+    if (!is_fresh) {
+      StartScan();
+    }
+  }
+
+  // Watch from the start, so an app installed before the first scan
+  // finishes, or while a fresh cache is shown, still triggers a rescan.
+  if (AppWatcher::IsSupported()) {
+    watcher_ = std::make_unique<AppWatcher>([this]() {
+      emit applicationsChanged();
+    });
+    if (!watcher_->Start(AppDiscovery::GetWatchDirectories())) {
+      watcher_.reset();
+    }
   }
 }
 
-AppBrowserWidget::~AppBrowserWidget() = default;
+AppBrowserWidget::~AppBrowserWidget() {
+  watcher_.reset();
+  scan_cancelled_ = true;
+  if (scan_thread_.joinable()) {
+    scan_thread_.join();
+  }
+}
 
 void AppBrowserWidget::SetupUI() {
   auto* main_layout = new QVBoxLayout(this);
@@ -114,6 +139,12 @@ void AppBrowserWidget::SetupUI() {
 
   main_layout->addLayout(content_layout, 1);
 
+  scan_progress_ = new QProgressBar(this);
+  scan_progress_->setTextVisible(false);
+  scan_progress_->setMaximumHeight(8);
+  scan_progress_->hide();
+  main_layout->addWidget(scan_progress_);
+
   status_label_ =
       new QLabel("Ready. Click 'Scan System' to discover applications.", this);
   status_label_->setStyleSheet(
@@ -135,27 +166,79 @@ void AppBrowserWidget::ConnectSignals() {
           &AppBrowserWidget::OnApplicationSelected);
   connect(add_button_, &QPushButton::clicked, this,
           &AppBrowserWidget::OnAddToLoafClicked);
+  connect(this, &AppBrowserWidget::scanProgress, this,
+          &AppBrowserWidget::OnScanProgress, Qt::QueuedConnection);
+  connect(this, &AppBrowserWidget::scanFinished, this,
+          &AppBrowserWidget::OnScanFinished, Qt::QueuedConnection);
+  connect(this, &AppBrowserWidget::applicationsChanged, this,
+          &AppBrowserWidget::OnApplicationsChanged, Qt::QueuedConnection);
 }
 
-void AppBrowserWidget::OnScanClicked() {
-  QProgressDialog progress("Scanning system for applications...", "Cancel", 0,
-                           0, this);
-  progress.setWindowModality(Qt::WindowModal);
-  progress.show();
+void AppBrowserWidget::OnScanClicked() { StartScan(); }
+
+void AppBrowserWidget::StartScan() {
+  if (scan_thread_.joinable()) {
+    rescan_pending_ = true;
+    return;
+  }
+
+  scan_button_->setEnabled(false);
+  scan_progress_->setRange(0, 0);
+  scan_progress_->show();
+  status_label_->setText("Scanning system for applications...");
+
+  // The scanner holds the stamps its scan actually saw, so it writes the
+  // cache; stamping from the display copy would cover later changes too.
+  const std::string cache_file =
+      (QDir::homePath() + "/.breadbin_app_cache").toStdString();
+  scan_thread_ = std::thread([this, scanner = scanner_.get(), cache_file]() {
+    ScanOptions options;
+    options.cancelled = &scan_cancelled_;
+    options.on_progress = [this](const ScanProgress& progress) {
+      emit scanProgress(static_cast<int>(progress.completed),
+                        static_cast<int>(progress.total),
+                        static_cast<int>(progress.found));
+    };
+    scanner->ScanSystem(options);
+    if (!scan_cancelled_) {
+      scanner->SaveCache(cache_file);
+    }
+    emit scanFinished();
+  });
+}
 
-  size_t count = discovery_->ScanSystem();
+void AppBrowserWidget::OnScanProgress(int completed, int total, int found) {
+  scan_progress_->setRange(0, total);
+  scan_progress_->setValue(completed);
+  status_label_->setText(
+      QString("Scanning... %1/%2 done, %3 applications found")
+          .arg(completed)
+          .arg(total)
+          .arg(found));
+}
 
-  progress.close();
+void AppBrowserWidget::OnScanFinished() {
+  if (scan_thread_.joinable()) {
+    scan_thread_.join();
+  }
+  scan_progress_->hide();
+  scan_button_->setEnabled(true);
 
+  discovery_->SetApplications(scanner_->GetApplications());
   PopulateCategories();
   UpdateApplicationList();
 
-  status_label_->setText(QString("Found %1 applications").arg(count));
+  status_label_->setText(QString("Found %1 applications")
+                             .arg(discovery_->GetApplicationCount()));
 
-  QString cache_file = QDir::homePath() + "/.breadbin_app_cache";
-  discovery_->SaveCache(cache_file.toStdString());
+  if (rescan_pending_) {
+    rescan_pending_ = false;
+    StartScan();
+  }
 }
 
+void AppBrowserWidget::OnApplicationsChanged() { StartScan(); }
+
 void AppBrowserWidget::OnSearchChanged(const QString& text) {
   UpdateApplicationList();
 }
@@ -175,14 +258,15 @@ void AppBrowserWidget::OnApplicationSelected() {
   add_button_->setEnabled(true);
 
   int index = app_list_->currentRow();
-  if (index >= 0 && index < filtered_apps_.size()) {
-    UpdateApplicationDetails(filtered_apps_[index]);
-    emit ApplicationSelected(filtered_apps_[index]);
+  if (index >= 0 && index < filtered_indices_.size()) {
+    const AppInfo app = discovery_->GetApplication(filtered_indices_[index]);
+    UpdateApplicationDetails(app);
+    emit ApplicationSelected(app);
   }
 }
 
 void AppBrowserWidget::OnAddToLoafClicked() {
-  const AppInfo* app = GetSelectedApplication();
+  const std::optional<AppInfo> app = GetSelectedApplication();
   if (app) {
     emit AddApplicationRequested(*app);
     status_label_->setText("Application added: " +
@@ -192,51 +276,48 @@ void AppBrowserWidget::OnAddToLoafClicked() {
 
 void AppBrowserWidget::RefreshApplications() { UpdateApplicationList(); }
 
-const AppInfo* AppBrowserWidget::GetSelectedApplication() const {
+std::optional<AppInfo> AppBrowserWidget::GetSelectedApplication() const {
   int index = app_list_->currentRow();
-  if (index >= 0 && index < filtered_apps_.size()) {
-    return &filtered_apps_[index];
+  if (index >= 0 && index < filtered_indices_.size()) {
+    return discovery_->GetApplication(filtered_indices_[index]);
   }
-  return nullptr;
+  return std::nullopt;
 }
 
 void AppBrowserWidget::UpdateApplicationList() {
   app_list_->clear();
-  filtered_apps_.clear();
-
-  const auto& all_apps = discovery_->GetApplications();
+  filtered_indices_.clear();
 
-  QString search_text = search_edit_->text().toLower();
-  QString category = category_combo_->currentText();
+  const std::string category = category_combo_->currentText().toStdString();
+  const bool all_categories = category_combo_->currentIndex() <= 0;
 
-  for (const auto& app : all_apps) {
-    if (!search_text.isEmpty()) {
-      QString app_name = QString::fromStdString(app.name).toLower();
-      if (!app_name.contains(search_text)) {
-        continue;
-      }
+  for (const size_t index :
+       discovery_->SearchApplications(search_edit_->text().toStdString())) {
+    if (all_categories ||
+        discovery_->GetApplicationCategory(index) == category) {
+      filtered_indices_.push_back(index);
     }
-
-    if (category != "All Categories") {
-      if (QString::fromStdString(app.category) != category) {
-        continue;
-      }
-    }
-
-    filtered_apps_.push_back(app);
   }
 
-  for (const auto& app : filtered_apps_) {
-    QString display_text = QString::fromStdString(app.name);
-    if (!app.category.empty()) {
-      display_text += " [" + QString::fromStdString(app.category) + "]";
+  // Reads names and categories straight from the loaded cache, so a cold
+  // start does not build an AppInfo per application.
+  for (const size_t index : filtered_indices_) {
+    const std::string_view name = discovery_->GetApplicationName(index);
+    const std::string_view app_category =
+        discovery_->GetApplicationCategory(index);
+    QString display_text = QString::fromUtf8(name.data(), name.size());
+    if (!app_category.empty()) {
+      display_text += " [" +
+                      QString::fromUtf8(app_category.data(),
+                                        app_category.size()) +
+                      "]";
     }
     app_list_->addItem(display_text);
   }
 
   status_label_->setText(QString("Showing %1 of %2 applications")
-                             .arg(filtered_apps_.size())
-                             .arg(all_apps.size()));
+                             .arg(filtered_indices_.size())
+                             .arg(discovery_->GetApplicationCount()));
 }
 
 void AppBrowserWidget::UpdateApplicationDetails(const AppInfo& app_info) {
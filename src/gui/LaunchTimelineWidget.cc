@@ -0,0 +1,140 @@
+#include "gui/LaunchTimelineWidget.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <algorithm>
+
+namespace BreadBin::GUI {
+namespace {
+constexpr int k_row_height = 22;
+constexpr int k_label_width = 160;
+constexpr int k_axis_height = 20;
+constexpr int k_margin = 8;
+
+const QColor k_queued_colour(0xd8, 0xcc, 0xb8);
+const QColor k_spawn_colour(0xe8, 0xa8, 0x58);
+const QColor k_startup_colour(0x90, 0xc8, 0x90);
+const QColor k_critical_colour(0xc8, 0x50, 0x50);
+const QColor k_text_colour(0x5d, 0x4e, 0x37);
+}  // namespace
+
+LaunchTimelineWidget::LaunchTimelineWidget(QWidget* parent)
+    : QWidget(parent), span_ms_(0.0) {
+  setMinimumHeight(k_axis_height + 2 * k_margin + k_row_height);
+}
+
+void LaunchTimelineWidget::SetTrace(const LaunchTrace& trace,
+                                    const QSet<QString>& critical_path) {
+  rows_.clear();
+  span_ms_ = 0.0;
+
+  auto offset = [&trace](const LaunchTimeline& timeline, LaunchPhase phase) {
+    return timeline.Has(phase) ? trace.GetOffsetMs(timeline, phase) : -1.0;
+  };
+
+  for (const auto& entry : trace.GetEntries()) {
+    Row row;
+    row.label = QString::fromStdString(entry.name.empty() ? entry.item_id
+                                                          : entry.name);
+    row.queued = offset(entry.timeline, LaunchPhase::QUEUED);
+    row.spawn_start = offset(entry.timeline, LaunchPhase::SPAWN_START);
+    row.spawn_done = offset(entry.timeline, LaunchPhase::SPAWN_DONE);
+    row.first_output = offset(entry.timeline, LaunchPhase::FIRST_OUTPUT);
+    row.ready = offset(entry.timeline, LaunchPhase::READY);
+    row.critical = critical_path.contains(QString::fromStdString(entry.item_id));
+    span_ms_ = std::max({span_ms_, row.queued, row.spawn_done, row.first_output,
+                         row.ready});
+    rows_.push_back(row);
+  }
+
+  setMinimumHeight(k_axis_height + 2 * k_margin +
+                   k_row_height * std::max(1, static_cast<int>(rows_.size())));
+  updateGeometry();
+  update();
+}
+
+void LaunchTimelineWidget::Clear() {
+  rows_.clear();
+  span_ms_ = 0.0;
+  update();
+}
+
+QSize LaunchTimelineWidget::sizeHint() const {
+  return QSize(600, k_axis_height + 2 * k_margin +
+                        k_row_height * std::max(1, static_cast<int>(rows_.size())));
+}
+
+void LaunchTimelineWidget::paintEvent(QPaintEvent* event) {
+  Q_UNUSED(event);
+  QPainter painter(this);
+  painter.setRenderHint(QPainter::Antialiasing);
+  painter.setPen(k_text_colour);
+
+  if (rows_.empty() || span_ms_ <= 0.0) {
+    painter.drawText(rect(), Qt::AlignCenter, "No launch recorded yet");
+    return;
+  }
+
+  const int chart_left = k_margin + k_label_width;
+  const int chart_width = std::max(1, width() - chart_left - k_margin);
+  auto to_x = [&](double ms) {
+    return chart_left + static_cast<int>(ms / span_ms_ * chart_width);
+  };
+  auto draw_bar = [&](int top, double from, double to, const QColor& colour) {
+    if (from < 0.0 || to < 0.0) {
+      return;
+    }
+    const int left = to_x(from);
+    const int right = std::max(left + 2, to_x(to));
+    painter.fillRect(QRect(left, top + 4, right - left, k_row_height - 8),
+                     colour);
+  };
+
+  for (size_t i = 0; i < rows_.size(); ++i) {
+    const Row& row = rows_[i];
+    const int top = k_margin + static_cast<int>(i) * k_row_height;
+
+    QFont font = painter.font();
+    font.setBold(row.critical);
+    painter.setFont(font);
+    painter.setPen(row.critical ? k_critical_colour : k_text_colour);
+    painter.drawText(QRect(k_margin, top, k_label_width - k_margin,
+                           k_row_height),
+                     Qt::AlignVCenter | Qt::AlignLeft,
+                     painter.fontMetrics().elidedText(
+                         row.label, Qt::ElideRight, k_label_width - k_margin));
+
+    if (row.spawn_start >= 0.0) {
+      draw_bar(top, row.queued, row.spawn_start, k_queued_colour);
+      draw_bar(top, row.spawn_start, row.spawn_done, k_spawn_colour);
+      draw_bar(top, row.spawn_done, row.ready, k_startup_colour);
+    } else {
+      draw_bar(top, row.queued, row.ready, k_startup_colour);
+    }
+    if (row.first_output >= 0.0) {
+      const int x = to_x(row.first_output);
+      painter.setPen(k_text_colour);
+      painter.drawLine(x, top + 2, x, top + k_row_height - 2);
+    }
+    if (row.critical && row.queued >= 0.0 && row.ready >= 0.0) {
+      painter.setPen(k_critical_colour);
+      painter.drawRect(QRect(to_x(row.queued), top + 3,
+                             std::max(2, to_x(row.ready) - to_x(row.queued)),
+                             k_row_height - 6));
+    }
+  }
+
+  const int axis_top =
+      k_margin + static_cast<int>(rows_.size()) * k_row_height + 4;
+  QFont font = painter.font();
+  font.setBold(false);
+  painter.setFont(font);
+  painter.setPen(k_text_colour);
+  painter.drawLine(chart_left, axis_top, chart_left + chart_width, axis_top);
+  painter.drawText(QRect(chart_left, axis_top, chart_width, k_axis_height),
+                   Qt::AlignLeft | Qt::AlignVCenter, "0 ms");
+  painter.drawText(QRect(chart_left, axis_top, chart_width, k_axis_height),
+                   Qt::AlignRight | Qt::AlignVCenter,
+                   QString("%1 ms").arg(span_ms_, 0, 'f', 1));
+}
+}  // namespace BreadBin::GUI
@@ -10,6 +10,7 @@
 #include <QMessageBox>
 #include <QStandardPaths>
 #include <QVBoxLayout>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -17,7 +18,7 @@
 
 namespace BreadBin::GUI {
 LoafBrowserWidget::LoafBrowserWidget(QWidget* parent)
-    : QWidget(parent), paths_label_(nullptr) {
+    : QWidget(parent), revalidate_pending_(false), paths_label_(nullptr) {
   QStringList default_paths;
   default_paths << QDir::homePath() + "/.breadbin/loafs";
   default_paths << QStandardPaths::writableLocation(
@@ -31,7 +32,11 @@ LoafBrowserWidget::LoafBrowserWidget(QWidget* parent)
   RefreshLoafFiles();
 }
 
-LoafBrowserWidget::~LoafBrowserWidget() {}
+LoafBrowserWidget::~LoafBrowserWidget() {
+  if (validation_thread_.joinable()) {
+    validation_thread_.join();
+  }
+}
 
 void LoafBrowserWidget::SetupUI() {
   QVBoxLayout* main_layout = new QVBoxLayout(this);
@@ -142,6 +147,8 @@ void LoafBrowserWidget::ConnectSignals() {
           &LoafBrowserWidget::OnOpenClicked);
   connect(delete_button_, &QPushButton::clicked, this,
           &LoafBrowserWidget::OnDeleteClicked);
+  connect(this, &LoafBrowserWidget::validationFinished, this,
+          &LoafBrowserWidget::OnValidationFinished, Qt::QueuedConnection);
 }
 
 void LoafBrowserWidget::SetSearchPaths(const QStringList& paths) {
@@ -154,6 +161,7 @@ void LoafBrowserWidget::SetSearchPaths(const QStringList& paths) {
 void LoafBrowserWidget::RefreshLoafFiles() {
   ScanForLoafFiles();
   UpdateLoafList();
+  StartValidation();
 }
 
 void LoafBrowserWidget::ScanForLoafFiles() {
@@ -166,7 +174,7 @@ void LoafBrowserWidget::ScanForLoafFiles() {
     }
 
     QStringList filters;
-    filters << "*.loaf";
+    filters << "*.loaf" << "*.loafb";
 
     QFileInfoList files = dir.entryInfoList(filters, QDir::Files);
     for (const QFileInfo& fileInfo : files) {
@@ -179,18 +187,85 @@ void LoafBrowserWidget::ScanForLoafFiles() {
       QString("Found %1 loaf files").arg(loaf_files_.size()));
 }
 
+void LoafBrowserWidget::StartValidation() {
+  if (validation_thread_.joinable()) {
+    revalidate_pending_ = true;
+    return;
+  }
+
+  std::vector<std::string> paths;
+  paths.reserve(loaf_files_.size());
+  for (const auto& info : loaf_files_) {
+    paths.push_back(info.filepath.toStdString());
+  }
+
+  // Loading every loaf and checking its paths can block on slow mounts, so
+  // it runs off the GUI thread. The engine outlives each refresh, and paths
+  // checked within its TTL are answered from its cache.
+  validation_thread_ = std::thread([this, paths = std::move(paths)]() {
+    std::vector<std::shared_ptr<Loaf>> loafs;
+    loafs.reserve(paths.size());
+    for (const auto& path : paths) {
+      auto loaf = std::make_shared<Loaf>();
+      loafs.push_back(loaf->Load(path) ? loaf : nullptr);
+    }
+
+    std::vector<QStringList> results(paths.size());
+    for (const auto& issue : validation_engine_.Validate(loafs).broken) {
+      results[issue.loaf_index]
+          << QString::fromStdString(issue.item_id + ": " + issue.reason);
+    }
+    validated_paths_ = paths;
+    validation_results_ = std::move(results);
+    emit validationFinished();
+  });
+}
+
+void LoafBrowserWidget::OnValidationFinished() {
+  if (validation_thread_.joinable()) {
+    validation_thread_.join();
+  }
+
+  for (auto& info : loaf_files_) {
+    const auto it = std::find(validated_paths_.begin(), validated_paths_.end(),
+                              info.filepath.toStdString());
+    if (it != validated_paths_.end()) {
+      info.brokenItems = validation_results_[it - validated_paths_.begin()];
+      info.brokenCount = static_cast<int>(info.brokenItems.size());
+    }
+  }
+
+  const int row = file_list_->currentRow();
+  const QString selected = row >= 0 && row < filtered_files_.size()
+                               ? filtered_files_[row].filepath
+                               : QString();
+  UpdateLoafList();
+  for (size_t i = 0; i < filtered_files_.size(); ++i) {
+    if (filtered_files_[i].filepath == selected) {
+      file_list_->setCurrentRow(static_cast<int>(i));
+      break;
+    }
+  }
+
+  if (revalidate_pending_) {
+    revalidate_pending_ = false;
+    StartValidation();
+  }
+}
+
 LoafFileInfo LoafBrowserWidget::LoadLoafInfo(const QString& filepath) {
   LoafFileInfo info;
   info.filepath = filepath;
+  info.brokenCount = 0;
 
   QFileInfo fileInfo(filepath);
   info.lastModified = fileInfo.lastModified().toString("yyyy-MM-dd HH:mm:ss");
 
-  BreadBin::Loaf loaf;
-  if (loaf.Load(filepath.toStdString())) {
-    info.name = QString::fromStdString(loaf.GetName());
-    info.description = QString::fromStdString(loaf.GetDescription());
-    info.itemCount = static_cast<int>(loaf.GetItems().size());
+  BreadBin::LoafSummary summary;
+  if (BreadBin::Loaf::ReadSummary(filepath.toStdString(), &summary)) {
+    info.name = QString::fromStdString(summary.name);
+    info.description = QString::fromStdString(summary.description);
+    info.itemCount = static_cast<int>(summary.item_count);
   } else {
     info.itemCount = 0;
   }
@@ -288,6 +363,9 @@ void LoafBrowserWidget::UpdateLoafList() {
     if (loaf.itemCount > 0) {
       display_text += QString(" (%1 items)").arg(loaf.itemCount);
     }
+    if (loaf.brokenCount > 0) {
+      display_text += QString(" ⚠️ %1 broken").arg(loaf.brokenCount);
+    }
     file_list_->addItem(display_text);
   }
 
@@ -308,6 +386,13 @@ void LoafBrowserWidget::UpdateLoafPreview(const LoafFileInfo& info) {
   preview += "<p><b>File:</b> <code>" + info.filepath + "</code></p>";
   preview += "<p><b>Items:</b> " + QString::number(info.itemCount) + "</p>";
   preview += "<p><b>Last Modified:</b> " + info.lastModified + "</p>";
+  if (!info.brokenItems.isEmpty()) {
+    preview += "<p><b>Broken items:</b></p><ul>";
+    for (const QString& broken : info.brokenItems) {
+      preview += "<li>" + broken.toHtmlEscaped() + "</li>";
+    }
+    preview += "</ul>";
+  }
 
   std::ifstream file(info.filepath.toStdString());
   if (file.is_open()) {
@@ -15,7 +15,7 @@
 #include <QStandardPaths>
 #include <QVBoxLayout>
 #include <algorithm>
-#include <sstream>
+#include <unordered_set>
 
 #include "AppDiscovery.h"
 
@@ -207,7 +207,16 @@ QString LoafEditorWidget::GenerateItemId(const QString& name) const {
     sanitized = sanitized.left(50);
   }
 
-  return sanitized;
+  auto loaf = editor_->GetCurrentLoaf();
+  if (!loaf) {
+    return sanitized;
+  }
+
+  QString unique = sanitized;
+  for (int suffix = 2; loaf->HasItem(unique.toStdString()); ++suffix) {
+    unique = sanitized + "_" + QString::number(suffix);
+  }
+  return unique;
 }
 
 void LoafEditorWidget::NewLoaf() {
@@ -371,9 +380,10 @@ void LoafEditorWidget::OnAddApplication() {
     app_combo->addItem("-- Browse for application --", "");
 
     const std::string query = text.trimmed().toStdString();
-    const auto filtered_apps = discovery.SearchApplications(query);
+    const auto& all_apps = discovery.GetApplications();
 
-    for (const auto& app : filtered_apps) {
+    for (const size_t index : discovery.SearchApplications(query)) {
+      const AppInfo& app = all_apps[index];
       if (app.name.empty() || app.executable.empty()) {
         continue;
       }
@@ -687,23 +697,30 @@ void LoafEditorWidget::OnConfigureItem() {
   QListWidget* deps_list = new QListWidget(&dialog);
   deps_list->setSelectionMode(QAbstractItemView::MultiSelection);
 
-  const auto& all_items = loaf->GetItems();
-  for (const auto& other_item : all_items) {
-    if (other_item->GetId() != loaf_item->GetId()) {
-      QString itemName = QString::fromStdString(other_item->GetName());
-      deps_list->addItem(itemName);
-
-      std::string dep_meta = loaf_item->GetMetadata("depends_on");
-      if (!dep_meta.empty()) {
-        std::istringstream ss(dep_meta);
-        std::string token;
-        while (std::getline(ss, token, ',')) {
-          if (token == other_item->GetId()) {
-            deps_list->item(deps_list->count() - 1)->setSelected(true);
-            break;
-          }
-        }
-      }
+  const auto graph = loaf->GetDependencyGraph();
+  size_t item_index = 0;
+  std::unordered_set<size_t> current_deps;
+  std::unordered_set<size_t> dependents;
+  if (graph->FindIndex(loaf_item->GetId(), &item_index)) {
+    const auto& dependencies = graph->GetDependencies(item_index);
+    current_deps.insert(dependencies.begin(), dependencies.end());
+    const auto transitive = graph->GetTransitiveDependents(item_index);
+    dependents.insert(transitive.begin(), transitive.end());
+  }
+
+  for (size_t i = 0; i < graph->GetNodeCount(); ++i) {
+    const auto& other_item = graph->GetItem(i);
+    if (other_item == loaf_item) {
+      continue;
+    }
+    auto* entry = new QListWidgetItem(
+        QString::fromStdString(other_item->GetName()), deps_list);
+    entry->setData(Qt::UserRole, QString::fromStdString(other_item->GetId()));
+    entry->setSelected(current_deps.count(i) != 0);
+    if (dependents.count(i) != 0) {
+      entry->setFlags(entry->flags() & ~Qt::ItemIsEnabled);
+      entry->setToolTip("Depends on this item; selecting it would create a "
+                        "cycle");
     }
   }
 
@@ -759,13 +776,7 @@ void LoafEditorWidget::OnConfigureItem() {
     QStringList selectedDeps;
     for (int i = 0; i < deps_list->count(); ++i) {
       if (deps_list->item(i)->isSelected()) {
-        QString selected_name = deps_list->item(i)->text();
-        for (const auto& other_item : all_items) {
-          if (QString::fromStdString(other_item->GetName()) == selected_name) {
-            selectedDeps.append(QString::fromStdString(other_item->GetId()));
-            break;
-          }
-        }
+        selectedDeps.append(deps_list->item(i)->data(Qt::UserRole).toString());
       }
     }
     loaf_item->SetMetadata("depends_on", selectedDeps.join(",").toStdString());
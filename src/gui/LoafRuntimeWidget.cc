@@ -1,22 +1,39 @@
 #include "gui/LoafRuntimeWidget.h"
 
+#include <QFileDialog>
+#include <QFontDatabase>
 #include <QGroupBox>
 #include <QHBoxLayout>
+#include <QMessageBox>
+#include <QSignalBlocker>
 #include <QVBoxLayout>
 
 namespace BreadBin::GUI {
+namespace {
+constexpr int k_output_poll_interval_ms = 250;
+constexpr int k_output_max_lines = 2000;
+}  // namespace
+
 LoafRuntimeWidget::LoafRuntimeWidget(QWidget* parent)
-    : QWidget(parent), current_loaf_(nullptr) {
+    : QWidget(parent),
+      current_loaf_(nullptr),
+      output_position_(0),
+      launching_(false) {
   SetupUI();
   ConnectSignals();
-
-  status_timer_ = new QTimer(this);
-  status_timer_->setInterval(2000);
-  connect(status_timer_, &QTimer::timeout, this,
-          &LoafRuntimeWidget::UpdateStatus);
 }
 
-LoafRuntimeWidget::~LoafRuntimeWidget() = default;
+LoafRuntimeWidget::~LoafRuntimeWidget() {
+  if (current_loaf_) {
+    if (current_loaf_->IsLaunching()) {
+      current_loaf_->Stop();
+    }
+    // on_finished emits through this widget from the launch thread, which
+    // can still be running after the launch itself has finished.
+    current_loaf_->WaitForLaunch();
+    current_loaf_->SetItemEventCallback(nullptr);
+  }
+}
 
 void LoafRuntimeWidget::SetupUI() {
   QVBoxLayout* main_layout = new QVBoxLayout(this);
@@ -53,6 +70,35 @@ void LoafRuntimeWidget::SetupUI() {
 
   main_layout->addWidget(items_group, 1);
 
+  QGroupBox* timeline_group = new QGroupBox("⏱️ Launch Timeline", this);
+  QVBoxLayout* timeline_layout = new QVBoxLayout(timeline_group);
+  timeline_layout->setContentsMargins(12, 20, 12, 12);
+
+  timeline_widget_ = new LaunchTimelineWidget(this);
+  timeline_layout->addWidget(timeline_widget_);
+
+  export_trace_button_ = new QPushButton("Export Trace...", this);
+  export_trace_button_->setEnabled(false);
+  timeline_layout->addWidget(export_trace_button_, 0, Qt::AlignRight);
+
+  main_layout->addWidget(timeline_group);
+
+  QGroupBox* output_group = new QGroupBox("📜 Output", this);
+  QVBoxLayout* output_layout = new QVBoxLayout(output_group);
+  output_layout->setContentsMargins(12, 20, 12, 12);
+
+  output_view_ = new QPlainTextEdit(this);
+  output_view_->setReadOnly(true);
+  output_view_->setMaximumBlockCount(k_output_max_lines);
+  output_view_->setPlaceholderText("Select an item to follow its output");
+  output_view_->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+  output_layout->addWidget(output_view_);
+
+  main_layout->addWidget(output_group, 1);
+
+  output_timer_ = new QTimer(this);
+  output_timer_->setInterval(k_output_poll_interval_ms);
+
   QHBoxLayout* button_layout = new QHBoxLayout();
   button_layout->setSpacing(12);
 
@@ -120,75 +166,296 @@ void LoafRuntimeWidget::ConnectSignals() {
           &LoafRuntimeWidget::OnStopLoaf);
   connect(refresh_button_, &QPushButton::clicked, this,
           &LoafRuntimeWidget::OnRefreshStatus);
+  connect(export_trace_button_, &QPushButton::clicked, this,
+          &LoafRuntimeWidget::OnExportTrace);
+  connect(item_status_list_, &QListWidget::currentRowChanged, this,
+          &LoafRuntimeWidget::OnSelectedItemChanged);
+  connect(output_timer_, &QTimer::timeout, this,
+          &LoafRuntimeWidget::OnTailOutput);
+  connect(this, &LoafRuntimeWidget::itemStatusChanged, this,
+          &LoafRuntimeWidget::OnItemStatusChanged, Qt::QueuedConnection);
+  connect(this, &LoafRuntimeWidget::itemLaunched, this,
+          &LoafRuntimeWidget::OnItemLaunched, Qt::QueuedConnection);
+  connect(this, &LoafRuntimeWidget::launchFinished, this,
+          &LoafRuntimeWidget::OnLaunchFinished, Qt::QueuedConnection);
 }
 
 void LoafRuntimeWidget::SetLoaf(std::shared_ptr<Loaf> loaf) {
+  if (current_loaf_ && current_loaf_ != loaf) {
+    current_loaf_->SetItemEventCallback(nullptr);
+    item_states_.clear();
+    item_details_.clear();
+    item_restarts_.clear();
+    item_last_exit_codes_.clear();
+    launching_ = false;
+    timeline_widget_->Clear();
+    export_trace_button_->setEnabled(false);
+    output_item_id_.clear();
+    output_position_ = 0;
+    output_view_->clear();
+    output_timer_->stop();
+  }
   current_loaf_ = loaf;
 
   if (current_loaf_) {
+    current_loaf_->SetItemEventCallback([this](const ItemEvent& event) {
+      emit itemStatusChanged(QString::fromStdString(event.item_id),
+                             static_cast<int>(event.state), event.exit_code,
+                             event.restart_count);
+    });
     loaf_name_label_->setText(QString::fromStdString(current_loaf_->GetName()));
     RefreshLoafStatus();
   } else {
     loaf_name_label_->setText("No loaf loaded");
     status_label_->setText("Status: Stopped");
     item_status_list_->clear();
+    item_rows_.clear();
   }
 }
 
 void LoafRuntimeWidget::OnRunLoaf() {
-  if (current_loaf_) {
-    if (current_loaf_->Run()) {
-      status_label_->setText("Status: Running");
-      run_button_->setEnabled(false);
-      stop_button_->setEnabled(true);
-      status_timer_->start();
-      emit loafStarted();
-    } else {
-      status_label_->setText("Status: Failed to start");
-    }
+  if (!current_loaf_ || launching_) {
+    return;
   }
+
+  item_states_.clear();
+  item_details_.clear();
+  item_restarts_.clear();
+  item_last_exit_codes_.clear();
+  timeline_widget_->Clear();
+  RefreshLoafStatus();
+
+  RunOptions options;
+  options.policy = current_loaf_->GetLaunchPolicy();
+  options.on_item_result = [this](const ItemLaunchResult& result) {
+    emit itemLaunched(QString::fromStdString(result.item_id), result.launched,
+                      result.latency.count(),
+                      QString::fromStdString(result.error));
+  };
+  options.on_finished = [this](const LaunchReport& report) {
+    emit launchFinished(report.success, QString::fromStdString(report.error));
+  };
+
+  launching_ = true;
+  status_label_->setText("Status: Starting...");
+  SetControlsRunning(true);
+  current_loaf_->RunAsync(std::move(options));
 }
 
 void LoafRuntimeWidget::OnStopLoaf() {
   if (current_loaf_) {
+    launching_ = false;
     if (current_loaf_->Stop()) {
       status_label_->setText("Status: Stopped");
-      run_button_->setEnabled(true);
-      stop_button_->setEnabled(false);
-      status_timer_->stop();
+      SetControlsRunning(false);
       emit loafStopped();
     }
   }
 }
 
+void LoafRuntimeWidget::OnItemLaunched(const QString& item_id, bool launched,
+                                       qint64 latency_us,
+                                       const QString& error) {
+  item_details_[item_id] =
+      launched ? QString("started in %1 ms").arg(latency_us / 1000.0, 0, 'f', 1)
+               : error;
+  UpdateItemRow(item_id);
+  RefreshTimeline();
+}
+
+void LoafRuntimeWidget::OnLaunchFinished(bool success, const QString& error) {
+  if (!launching_ || !current_loaf_) {
+    return;
+  }
+  launching_ = false;
+  RefreshTimeline();
+
+  if (current_loaf_->IsRunning()) {
+    status_label_->setText(success ? QString("Status: Running")
+                                   : "Status: Running (" + error + ")");
+    SetControlsRunning(true);
+    emit loafStarted();
+    return;
+  }
+
+  QString message = "Status: Failed to start";
+  if (!error.isEmpty()) {
+    message += " (" + error + ")";
+  }
+  status_label_->setText(message);
+  SetControlsRunning(false);
+}
+
+void LoafRuntimeWidget::OnExportTrace() {
+  if (!current_loaf_) {
+    return;
+  }
+
+  const QString filepath = QFileDialog::getSaveFileName(
+      this, "Export Launch Trace", "launch_trace.json",
+      "Chrome Trace (*.json);;All Files (*)");
+  if (filepath.isEmpty()) {
+    return;
+  }
+
+  if (!current_loaf_->GetLaunchTrace().ExportChromeTrace(
+          filepath.toStdString())) {
+    QMessageBox::warning(this, "Export Failed",
+                         "Could not write trace to " + filepath);
+  }
+}
+
+void LoafRuntimeWidget::OnSelectedItemChanged() {
+  QListWidgetItem* list_item = item_status_list_->currentItem();
+  const QString item_id =
+      list_item ? list_item->data(Qt::UserRole).toString() : QString();
+  if (item_id == output_item_id_) {
+    return;
+  }
+
+  output_item_id_ = item_id;
+  output_position_ = 0;
+  output_view_->clear();
+  if (output_item_id_.isEmpty()) {
+    output_timer_->stop();
+    return;
+  }
+  OnTailOutput();
+  output_timer_->start();
+}
+
+void LoafRuntimeWidget::OnTailOutput() {
+  if (!current_loaf_ || output_item_id_.isEmpty()) {
+    return;
+  }
+
+  auto item = current_loaf_->GetItem(output_item_id_.toStdString());
+  const auto output = item ? item->GetOutput() : nullptr;
+  if (!output) {
+    return;
+  }
+
+  const std::string text =
+      output->ReadSince(output_position_, &output_position_);
+  if (text.empty()) {
+    return;
+  }
+  output_view_->moveCursor(QTextCursor::End);
+  output_view_->insertPlainText(QString::fromUtf8(text.data(), text.size()));
+  output_view_->moveCursor(QTextCursor::End);
+}
+
+void LoafRuntimeWidget::RefreshTimeline() {
+  if (!current_loaf_) {
+    return;
+  }
+
+  QSet<QString> critical_path;
+  if (!launching_) {
+    for (const auto& id : current_loaf_->GetLaunchCriticalPath()) {
+      critical_path.insert(QString::fromStdString(id));
+    }
+  }
+  timeline_widget_->SetTrace(current_loaf_->GetLaunchTrace(), critical_path);
+  export_trace_button_->setEnabled(true);
+}
+
+void LoafRuntimeWidget::SetControlsRunning(bool running) {
+  run_button_->setEnabled(!running);
+  stop_button_->setEnabled(running);
+}
+
 void LoafRuntimeWidget::OnRefreshStatus() { RefreshLoafStatus(); }
 
-void LoafRuntimeWidget::UpdateStatus() { RefreshLoafStatus(); }
+void LoafRuntimeWidget::OnItemStatusChanged(const QString& item_id,
+                                            int state, int exit_code,
+                                            int restart_count) {
+  const auto item_state = static_cast<ItemState>(state);
+  item_states_[item_id] = DescribeState(item_state, exit_code);
+  item_restarts_[item_id] = restart_count;
+  if (item_state == ItemState::EXITED || item_state == ItemState::RESTARTING) {
+    item_last_exit_codes_[item_id] = exit_code;
+  }
+  UpdateItemRow(item_id);
+}
+
+QString LoafRuntimeWidget::DescribeState(ItemState state, int exit_code) {
+  switch (state) {
+    case ItemState::RUNNING:
+      return "Running";
+    case ItemState::EXITED:
+      return exit_code == 0 ? QString("Exited")
+                            : QString("Exited (code %1)").arg(exit_code);
+    case ItemState::FAILED:
+      return "Failed to start";
+    case ItemState::RESTARTING:
+      return QString("Restarting (code %1)").arg(exit_code);
+    default:
+      return "Idle";
+  }
+}
+
+void LoafRuntimeWidget::UpdateItemRow(const QString& item_id) {
+  if (!current_loaf_) return;
+
+  auto row = item_rows_.constFind(item_id);
+  auto item = current_loaf_->GetItem(item_id.toStdString());
+  if (row == item_rows_.constEnd() || !item) {
+    return;
+  }
+
+  QListWidgetItem* list_item = item_status_list_->item(row.value());
+  if (list_item) {
+    QString text = QString::fromStdString(item->GetName()) + " - " +
+                   item_states_.value(item_id, "Idle");
+    const QString detail = item_details_.value(item_id);
+    if (!detail.isEmpty()) {
+      text += " (" + detail + ")";
+    }
+    const int restarts = item_restarts_.value(item_id);
+    if (restarts > 0) {
+      text += QString(" [restarts: %1, last exit: %2]")
+                  .arg(restarts)
+                  .arg(item_last_exit_codes_.value(item_id));
+    }
+    list_item->setText(text);
+  }
+}
 
 void LoafRuntimeWidget::RefreshLoafStatus() {
   if (!current_loaf_) return;
 
-  item_status_list_->clear();
+  {
+    const QSignalBlocker blocker(item_status_list_);
+    item_status_list_->clear();
+    item_rows_.clear();
 
-  const auto& items = current_loaf_->GetItems();
-  for (const auto& item : items) {
-    QString status = QString::fromStdString(item->GetName());
-    if (current_loaf_->IsRunning()) {
-      status += " - Running";
-    } else {
-      status += " - Idle";
+    const auto& items = current_loaf_->GetItems();
+    for (const auto& item : items) {
+      const QString item_id = QString::fromStdString(item->GetId());
+      if (!item_states_.contains(item_id) && item->IsProcessRunning()) {
+        item_states_[item_id] = DescribeState(ItemState::RUNNING, 0);
+      }
+      item_rows_[item_id] = item_status_list_->count();
+      QListWidgetItem* list_item = new QListWidgetItem(item_status_list_);
+      list_item->setData(Qt::UserRole, item_id);
+      UpdateItemRow(item_id);
+    }
+    if (item_rows_.contains(output_item_id_)) {
+      item_status_list_->setCurrentRow(item_rows_.value(output_item_id_));
     }
-    item_status_list_->addItem(status);
   }
+  OnSelectedItemChanged();
 
-  if (current_loaf_->IsRunning()) {
+  if (launching_ || current_loaf_->IsLaunching()) {
+    status_label_->setText("Status: Starting...");
+    SetControlsRunning(true);
+  } else if (current_loaf_->IsRunning()) {
     status_label_->setText("Status: Running");
-    run_button_->setEnabled(false);
-    stop_button_->setEnabled(true);
+    SetControlsRunning(true);
   } else {
     status_label_->setText("Status: Stopped");
-    run_button_->setEnabled(true);
-    stop_button_->setEnabled(false);
+    SetControlsRunning(false);
   }
 }
 }  // namespace BreadBin::GUI
\ No newline at end of file
@@ -628,7 +628,7 @@ void MainWindow::OpenLoaf() {
 
   QString filepath =
       QFileDialog::getOpenFileName(this, "Open Loaf", GetDefaultLoafDirectory(),
-                                   "Loaf Files (*.loaf);;All Files (*)");
+                                   "Loaf Files (*.loaf);;Binary Loaf Files (*.loafb);;All Files (*)");
 
   if (!filepath.isEmpty()) {
     OpenLoafFile(filepath);
@@ -697,10 +697,10 @@ void MainWindow::SaveLoafAs() {
   }
 
   QString filepath = QFileDialog::getSaveFileName(
-      this, "Save Loaf As", default_path, "Loaf Files (*.loaf);;All Files (*)");
+      this, "Save Loaf As", default_path, "Loaf Files (*.loaf);;Binary Loaf Files (*.loafb);;All Files (*)");
 
   if (!filepath.isEmpty()) {
-    if (!filepath.endsWith(".loaf")) {
+    if (!filepath.endsWith(".loaf") && !filepath.endsWith(".loafb")) {
       filepath += ".loaf";
     }
 
@@ -0,0 +1,78 @@
+#include <charconv>
+#include <iostream>
+#include <string>
+
+#include "ControlProtocol.h"
+#include "cli/BatchCommands.h"
+#include "cli/ReportWriter.h"
+
+namespace {
+void PrintUsage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " <run|stop|validate|convert|list|stats> [options] FILE...\n"
+               "Options:\n"
+               "  --json           print machine-readable JSON\n"
+               "  -j N             process up to N files in parallel\n"
+               "  --socket PATH    breadbind socket for run and stop\n"
+               "  --to FORMAT      convert to 'text' or 'binary'\n"
+               "  -o FILE          convert output (single input only)\n";
+}
+}  // namespace
+
+int main(int argument_count, char* argument_vector[]) {
+  using BreadBin::Cli::BatchCommands;
+  using BreadBin::Cli::BatchOptions;
+  using BreadBin::Cli::ReportWriter;
+
+  if (argument_count < 2 || !BatchCommands::IsCommand(argument_vector[1])) {
+    PrintUsage(argument_vector[0]);
+    return 2;
+  }
+
+  const std::string command = argument_vector[1];
+  BatchOptions options;
+  options.socket_path = BreadBin::ControlProtocol::DefaultSocketPath();
+  bool json = false;
+  for (int i = 2; i < argument_count; ++i) {
+    const std::string argument = argument_vector[i];
+    const bool has_value = i + 1 < argument_count;
+    if (argument == "--json") {
+      json = true;
+    } else if (argument == "-j" && has_value) {
+      const std::string value = argument_vector[++i];
+      const auto result = std::from_chars(
+          value.data(), value.data() + value.size(), options.jobs);
+      if (result.ec != std::errc() || options.jobs == 0) {
+        PrintUsage(argument_vector[0]);
+        return 2;
+      }
+    } else if (argument == "--socket" && has_value) {
+      options.socket_path = argument_vector[++i];
+    } else if (argument == "--to" && has_value) {
+      options.convert_format = argument_vector[++i];
+    } else if (argument == "-o" && has_value) {
+      options.output_path = argument_vector[++i];
+    } else if (!argument.empty() && argument.front() == '-') {
+      PrintUsage(argument_vector[0]);
+      return 2;
+    } else {
+      options.files.push_back(argument);
+    }
+  }
+
+  if (options.files.empty() ||
+      (!options.output_path.empty() && options.files.size() != 1)) {
+    PrintUsage(argument_vector[0]);
+    return 2;
+  }
+
+  const auto reports = BatchCommands::Run(command, options);
+  std::cout << (json ? ReportWriter::ToJson(command, reports)
+                     : ReportWriter::ToText(reports));
+  for (const auto& report : reports) {
+    if (!report.ok) {
+      return 1;
+    }
+  }
+  return 0;
+}
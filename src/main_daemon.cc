@@ -0,0 +1,48 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ControlProtocol.h"
+#include "daemon/LoafDaemon.h"
+
+namespace {
+void PrintUsage(const char* program) {
+  std::cerr << "Usage: " << program << " [--socket PATH] [LOAF...]\n";
+}
+}  // namespace
+
+int main(int argument_count, char* argument_vector[]) {
+  std::string socket_path = BreadBin::ControlProtocol::DefaultSocketPath();
+  std::vector<std::string> loaf_files;
+  for (int i = 1; i < argument_count; ++i) {
+    const std::string argument = argument_vector[i];
+    if (argument == "--socket" && i + 1 < argument_count) {
+      socket_path = argument_vector[++i];
+    } else if (argument == "--help" || argument == "-h") {
+      PrintUsage(argument_vector[0]);
+      return 0;
+    } else if (!argument.empty() && argument.front() == '-') {
+      PrintUsage(argument_vector[0]);
+      return 2;
+    } else {
+      loaf_files.push_back(argument);
+    }
+  }
+
+  BreadBin::Daemon::LoafDaemon daemon(socket_path);
+  if (!daemon.Start()) {
+    std::cerr << "breadbind: " << daemon.GetLastError() << "\n";
+    return 1;
+  }
+
+  for (const auto& filepath : loaf_files) {
+    std::string error;
+    if (!daemon.StartLoaf(filepath, &error)) {
+      std::cerr << "breadbind: " << error << "\n";
+    }
+  }
+
+  std::cerr << "breadbind: listening on " << socket_path << "\n";
+  daemon.Run();
+  return 0;
+}